@@ -0,0 +1,195 @@
+#include <omp.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "util.hh"
+
+// Micro-benchmarks of the bitset kernels, written as CSV
+
+using siz_t = bitset::siz_t;
+using clk_t = std::chrono::steady_clock;
+
+// Build flavor, to tell results apart
+#if defined(DEBUG)
+static char const* const flavor = "debug";
+#elif defined(NOSIMD)
+static char const* const flavor = "nosimd";
+#else
+static char const* const flavor = "release";
+#endif
+
+// Operands shared by the kernels of a size
+struct operands {
+  bitset a, b, c, out;
+  // Truth tables of the largest number of inputs that fit the size
+  std::vector<bitset> combinations;
+};
+
+// A kernel, returning a value to keep it from being optimized away
+struct kernel {
+  char const* name;
+  // Bytes moved per bit of the operands
+  double bytes_per_bit;
+  // Largest size benchmarked (0 for no limit)
+  siz_t max_bits;
+  std::function<siz_t(operands&)> run;
+};
+
+// Largest number of inputs whose truth tables fit <bits> bits
+static siz_t combination_inputs (siz_t bits) {
+  siz_t inputs = 0;
+
+  while ((siz_t{ 2 } << inputs) <= bits) {
+    ++inputs;
+  }
+
+  return inputs;
+}
+
+static std::vector<kernel> const kernels = {
+  { "AND", 3.0 / 8, 0, [] (operands& op) {
+    return bitset::AND(op.a, op.b, op.out).popcount();
+  } },
+  { "OR", 3.0 / 8, 0, [] (operands& op) {
+    return bitset::OR(op.a, op.b, op.out).popcount();
+  } },
+  { "XOR", 3.0 / 8, 0, [] (operands& op) {
+    return bitset::XOR(op.a, op.b, op.out).popcount();
+  } },
+  { "MAJ", 4.0 / 8, 0, [] (operands& op) {
+    return bitset::MAJ(op.a, op.b, op.c, op.out).popcount();
+  } },
+  { "AND_popcount", 2.0 / 8, 0, [] (operands& op) {
+    return bitset::AND_popcount(op.a, op.b);
+  } },
+  { "XOR_popcount", 2.0 / 8, 0, [] (operands& op) {
+    return bitset::XOR_popcount(op.a, op.b);
+  } },
+  { "MAJ_popcount", 3.0 / 8, 0, [] (operands& op) {
+    return bitset::MAJ_popcount(op.a, op.b, op.c);
+  } },
+  { "AND3_popcount", 3.0 / 8, 0, [] (operands& op) {
+    return bitset::AND3_popcount(op.a, op.b, op.c);
+  } },
+  { "XOR_popcount_bounded", 2.0 / 8, 0, [] (operands& op) {
+    return bitset::XOR_popcount_bounded(op.a, op.b, op.a.size());
+  } },
+  { "build_combinations", 1.0 / 8, siz_t{ 1 } << 28, [] (operands& op) {
+    bitset::build_combinations(op.combinations.data(), op.combinations.size());
+    return op.combinations.size();
+  } },
+  { "random", 1.0 / 8, 0, [] (operands& op) {
+    return bitset::random(op.a.size(), 0.5, op.a.size()).popcount();
+  } },
+  { "copy", 2.0 / 8, 0, [] (operands& op) {
+    return op.a.copy().popcount();
+  } },
+  { "string", 1.0 / 8, siz_t{ 1 } << 28, [] (operands& op) {
+    return std::string{ op.a }.size();
+  } }
+};
+
+// Splits a comma separated list of numbers
+static std::vector<siz_t> split (std::string const& list) {
+  std::vector<siz_t> result;
+  std::istringstream ss{ list };
+
+  for (std::string item; std::getline(ss, item, ','); ) {
+    result.emplace_back(std::stoull(item));
+  }
+
+  return result;
+}
+
+int main (int argc, char const* const* const argv) {
+  util::argparse parser;
+  parser.add("--min-bits", "64");
+  parser.add("--max-bits", "8589934592");
+  parser.add("--threads", std::to_string(omp_get_max_threads()));
+  parser.add("--time", "0.2");
+  parser.add("--filter", "");
+  parser.add("--output", "-");
+  parser.add("--stream", "0");
+
+  util::argparse::params const args = parser.parse(argc, argv);
+
+  siz_t const min_bits = args.get<siz_t>("--min-bits");
+  siz_t const max_bits = args.get<siz_t>("--max-bits");
+  double const min_time = args.get<double>("--time");
+  std::string const filter = args.get<std::string>("--filter");
+  std::string const output = args.get<std::string>("--output");
+  std::vector<siz_t> threads = split(args.get<std::string>("--threads"));
+
+  // Streaming stores are opt-in, from the size of the last level cache
+  bool const stream = args.get<siz_t>("--stream");
+  std::string const variant = std::string{ flavor } + (stream ? "+stream" : "");
+
+  if (stream) {
+    bitset::stream_threshold = bitset::llc_buckets();
+  }
+
+  // Operands take four bitsets and the copying kernels one more
+  siz_t const memory = sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+
+  std::ofstream file;
+  std::ostream& out = (output == "-") ? std::cout : (file.open(output), file);
+
+  out << "kernel,flavor,threads,bits,buckets,reps,seconds,ns_per_bucket,gb_per_s\n";
+
+  for (siz_t bits = min_bits; bits <= max_bits; bits *= 4) {
+    if (5 * (bits / 8) > memory / 2) {
+      std::cerr << "Skipping " << bits << " bits, not enough memory\n";
+      break;
+    }
+
+    operands op;
+    op.a = bitset::random(bits, 0.5, 1);
+    op.b = bitset::random(bits, 0.5, 2);
+    op.c = bitset::random(bits, 0.5, 3);
+    op.out = bitset{ bits, false, false };
+
+    if (bits <= (siz_t{ 1 } << 28)) {
+      op.combinations.resize(combination_inputs(bits));
+    }
+
+    for (kernel const& k : kernels) {
+      if (!filter.empty() and std::string{ k.name }.find(filter) == std::string::npos) {
+        continue;
+      }
+
+      if (k.max_bits and bits > k.max_bits) {
+        continue;
+      }
+
+      for (siz_t const t : threads) {
+        omp_set_num_threads(t);
+
+        // Warm up, then repeat until the minimum time has passed
+        volatile siz_t sink = k.run(op);
+        siz_t reps = 0;
+        double seconds = 0;
+        clk_t::time_point const start = clk_t::now();
+
+        do {
+          sink = sink + k.run(op);
+          ++reps;
+          seconds = std::chrono::duration<double>(clk_t::now() - start).count();
+        } while (seconds < min_time);
+
+        double const each = seconds / reps;
+        siz_t const inputs = op.combinations.size();
+        double const bytes = (std::string{ k.name } == "build_combinations")
+          ? k.bytes_per_bit * inputs * (siz_t{ 1 } << inputs)
+          : k.bytes_per_bit * bits;
+
+        out << k.name << ',' << variant << ',' << t << ',' << bits << ','
+            << op.a.buckets() << ',' << reps << ',' << each << ','
+            << each * 1e9 / op.a.buckets() << ',' << bytes / each / 1e9 << '\n';
+        out.flush();
+      }
+    }
+  }
+
+  return 0;
+}
@@ -1,3 +1,9 @@
 #pragma once
 
 #include "bitset/base.hh"
+#include "bitset/graph.hh"
+#include "bitset/counter.hh"
+#include "bitset/array.hh"
+#include "bitset/lsh.hh"
+#include "bitset/bloom.hh"
+#include "bitset/npn.hh"
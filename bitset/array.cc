@@ -0,0 +1,289 @@
+#include <cstdlib>
+#include "array.hh"
+
+// Bucket type
+using bck_t = bitset_array::bck_t;
+// Size type
+using siz_t = bitset_array::siz_t;
+
+// Constructor of <count> zeroed rows of <size> bits
+bitset_array::bitset_array (siz_t count, siz_t size)
+: count_{ count }, size_{ size }, stride_{ bitset_array::count_stride(size) } {
+  this->alloc();
+  std::fill_n(this->slab_, this->count() * this->stride(), 0);
+}
+
+// Constructor from a list of bitsets of the same size
+bitset_array::bitset_array (bitset const* bsets, siz_t count)
+: bitset_array{ count, count ? bsets[0].size() : 0 } {
+  #pragma omp parallel for schedule(static)
+  for (siz_t i = 0; i < count; ++i) {
+    this->set(i, bsets[i]);
+  }
+}
+
+// Allocate slab and row handles
+void bitset_array::alloc (void) {
+  siz_t const total = this->count() * this->stride();
+
+  if (total != 0) {
+    this->slab_ = static_cast<bck_t*>(
+      std::aligned_alloc(bitset_array::alignment, total * sizeof(bck_t))
+    );
+  }
+
+  this->rows_ = new bitset[this->count()];
+
+  for (siz_t i = 0; i < this->count(); ++i) {
+    bitset::impl* impl = new bitset::impl;
+
+    impl->size_ = this->size();
+    impl->data_ = this->slab_ + i * this->stride();
+    impl->owner_ = false;
+
+    this->rows_[i].impl_ = impl;
+  }
+}
+
+// Release array storage
+void bitset_array::release (void) {
+  this->count_ = this->size_ = this->stride_ = 0;
+  this->slab_ = nullptr;
+  this->rows_ = nullptr;
+}
+
+// Free array memory
+void bitset_array::free (void) {
+  delete[] this->rows_;
+  std::free(this->slab_);
+  this->release();
+}
+
+// Copy metadata from other array
+void bitset_array::copy_meta (bitset_array const& ot) {
+  this->count_ = ot.count_;
+  this->size_ = ot.size_;
+  this->stride_ = ot.stride_;
+}
+
+// Copy from another array
+bitset_array& bitset_array::copy_from (bitset_array const& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+    this->alloc();
+
+    std::copy_n(ot.slab_, this->count() * this->stride(), this->slab_);
+
+    for (siz_t i = 0; i < this->count(); ++i) {
+      this->rows_[i].impl_->popcount_ = ot.rows_[i].impl_->popcount_;
+    }
+  }
+
+  return *this;
+}
+
+// Move from another array
+bitset_array& bitset_array::move_from (bitset_array& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+    this->slab_ = ot.slab_;
+    this->rows_ = ot.rows_;
+    ot.release();
+  }
+
+  return *this;
+}
+
+// Copies the contents of a bitset into a row
+void bitset_array::set (siz_t pos, bitset const& bs) {
+  bitset& row = this->rows_[pos];
+  siz_t const last = row.buckets() - 1;
+
+  for (siz_t j = 0; j < last; ++j) {
+    row.data(j) = bs.bucket(j);
+  }
+
+  row.data(last) = bs.bucket(last) & row.last_mask();
+  row.impl_->popcount_ = bs.popcount();
+}
+
+// Popcounts of each row against a target
+void bitset_array::AND_popcount (bitset const& target, siz_t* out) const {
+  siz_t const last = this->buckets() - 1;
+  bck_t const mask = target.last_mask();
+
+  // Rows are streamed linearly from the slab
+  #pragma omp parallel for schedule(static)
+  for (siz_t i = 0; i < this->count(); ++i) {
+    bck_t const* row = this->data(i);
+    siz_t pop = 0;
+
+    #pragma omp simd reduction(+: pop)
+    for (siz_t j = 0; j < last; ++j) {
+      pop += util::popcount(row[j] & target.bucket(j));
+    }
+
+    out[i] = pop + util::popcount(row[last] & target.bucket(last) & mask);
+  }
+}
+
+void bitset_array::XOR_popcount (bitset const& target, siz_t* out) const {
+  siz_t const last = this->buckets() - 1;
+  bck_t const mask = target.last_mask();
+
+  // Rows are streamed linearly from the slab
+  #pragma omp parallel for schedule(static)
+  for (siz_t i = 0; i < this->count(); ++i) {
+    bck_t const* row = this->data(i);
+    siz_t pop = 0;
+
+    #pragma omp simd reduction(+: pop)
+    for (siz_t j = 0; j < last; ++j) {
+      pop += util::popcount(row[j] ^ target.bucket(j));
+    }
+
+    out[i] = pop + util::popcount((row[last] ^ target.bucket(last)) & mask);
+  }
+}
+
+// Popcounts of op over every pair i < j of rows, handing each tile of
+// pair_rows x pair_rows counts to <tile> (from several threads)
+template <typename OP, typename TILE>
+static void all_pairs (bitset_array const& arr, OP const& op, TILE const& tile) {
+  constexpr siz_t rows = bitset_array::pair_rows;
+  constexpr siz_t span = bitset_array::pair_buckets;
+
+  siz_t const count = arr.count();
+  siz_t const buckets = arr.buckets();
+  siz_t const tiles = (count + rows - 1) / rows;
+
+  // Padding buckets are zeroed, so whole rows are counted without masks
+  #pragma omp parallel for collapse(2) schedule(dynamic)
+  for (siz_t ti = 0; ti < tiles; ++ti) {
+    for (siz_t tj = 0; tj < tiles; ++tj) {
+      if (tj < ti) {
+        continue;
+      }
+
+      siz_t const i0 = ti * rows, i1 = std::min(i0 + rows, count);
+      siz_t const j0 = tj * rows, j1 = std::min(j0 + rows, count);
+      siz_t acc[rows][rows] = {};
+
+      for (siz_t k0 = 0; k0 < buckets; k0 += span) {
+        siz_t const k1 = std::min(k0 + span, buckets);
+
+        for (siz_t i = i0; i < i1; ++i) {
+          bck_t const* a = arr.data(i);
+
+          for (siz_t j = std::max(j0, i + 1); j < j1; ++j) {
+            bck_t const* b = arr.data(j);
+            siz_t pop = 0;
+
+            #pragma omp simd reduction(+: pop)
+            for (siz_t k = k0; k < k1; ++k) {
+              pop += util::popcount(op(a[k], b[k]));
+            }
+
+            acc[i - i0][j - j0] += pop;
+          }
+        }
+      }
+
+      tile(i0, i1, j0, j1, acc);
+    }
+  }
+}
+
+// Bitwise operations of the all-pairs kernels
+static bck_t pair_xor (bck_t a, bck_t b) { return a ^ b; }
+static bck_t pair_and (bck_t a, bck_t b) { return a & b; }
+
+// Hamming distances as a full count x count matrix
+void bitset_array::hamming (siz_t* out) const {
+  siz_t const count = this->count();
+
+  all_pairs(*this, pair_xor, [ out, count ] (
+    siz_t i0, siz_t i1, siz_t j0, siz_t j1, siz_t const (*acc)[pair_rows]
+  ) {
+    for (siz_t i = i0; i < i1; ++i) {
+      for (siz_t j = std::max(j0, i + 1); j < j1; ++j) {
+        out[i * count + j] = out[j * count + i] = acc[i - i0][j - j0];
+      }
+    }
+  });
+
+  for (siz_t i = 0; i < count; ++i) {
+    out[i * count + i] = 0;
+  }
+}
+
+// Hamming distances of the pairs i < j, packed row by row
+void bitset_array::hamming_upper (siz_t* out) const {
+  siz_t const count = this->count();
+
+  all_pairs(*this, pair_xor, [ out, count ] (
+    siz_t i0, siz_t i1, siz_t j0, siz_t j1, siz_t const (*acc)[pair_rows]
+  ) {
+    for (siz_t i = i0; i < i1; ++i) {
+      // Position of the pair (i, i + 1)
+      siz_t const row = i * (2 * count - i - 1) / 2 - i - 1;
+
+      for (siz_t j = std::max(j0, i + 1); j < j1; ++j) {
+        out[row + j] = acc[i - i0][j - j0];
+      }
+    }
+  });
+}
+
+// Jaccard distances as a full count x count matrix
+void bitset_array::jaccard (double* out) const {
+  siz_t const count = this->count();
+  bitset const* rows = this->rows_;
+
+  all_pairs(*this, pair_and, [ out, count, rows ] (
+    siz_t i0, siz_t i1, siz_t j0, siz_t j1, siz_t const (*acc)[pair_rows]
+  ) {
+    for (siz_t i = i0; i < i1; ++i) {
+      for (siz_t j = std::max(j0, i + 1); j < j1; ++j) {
+        siz_t const inter = acc[i - i0][j - j0];
+        siz_t const uni = rows[i].popcount() + rows[j].popcount() - inter;
+        double const dist = uni ? 1.0 - double(inter) / double(uni) : 0.0;
+
+        out[i * count + j] = out[j * count + i] = dist;
+      }
+    }
+  });
+
+  for (siz_t i = 0; i < count; ++i) {
+    out[i * count + i] = 0.0;
+  }
+}
+
+// Sorted pairs i < j whose Hamming distance is at most threshold
+std::vector<std::pair<siz_t, siz_t>> bitset_array::hamming_pairs (
+  siz_t threshold
+) const {
+  std::vector<std::pair<siz_t, siz_t>> result;
+
+  all_pairs(*this, pair_xor, [ &result, threshold ] (
+    siz_t i0, siz_t i1, siz_t j0, siz_t j1, siz_t const (*acc)[pair_rows]
+  ) {
+    std::vector<std::pair<siz_t, siz_t>> found;
+
+    for (siz_t i = i0; i < i1; ++i) {
+      for (siz_t j = std::max(j0, i + 1); j < j1; ++j) {
+        if (acc[i - i0][j - j0] <= threshold) {
+          found.emplace_back(i, j);
+        }
+      }
+    }
+
+    #pragma omp critical
+    result.insert(result.end(), found.begin(), found.end());
+  });
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "base.hh"
+
+// Array of equal-size bitsets stored on a single aligned slab
+class bitset_array {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+
+  // Alignment of the slab and of each row, in bytes
+  constexpr static siz_t const alignment = 64;
+  // Number of buckets that fill an aligned block
+  constexpr static siz_t const align_buckets = alignment / sizeof(bck_t);
+
+  // Rows on each side of the tiles of all-pairs kernels
+  constexpr static siz_t const pair_rows = 16;
+  // Buckets of each row walked per tile, keeping both sides on L2
+  constexpr static siz_t const pair_buckets = 512;
+
+  // Number of buckets between consecutive rows
+  constexpr static siz_t count_stride (siz_t size) {
+    siz_t const buckets = bitset::count_buckets(size);
+    return ((buckets + align_buckets - 1) / align_buckets) * align_buckets;
+  }
+
+ private:
+  // Number of rows
+  siz_t count_ = 0;
+  // Bits of each row
+  siz_t size_ = 0;
+  // Buckets between consecutive rows
+  siz_t stride_ = 0;
+  // Row storage
+  bck_t* slab_ = nullptr;
+  // Non-owning handles to the rows
+  bitset* rows_ = nullptr;
+
+  void alloc (void);
+  void release (void);
+  void free (void);
+
+  void copy_meta (bitset_array const& ot);
+  bitset_array& copy_from (bitset_array const& ot);
+  bitset_array& move_from (bitset_array& ot);
+
+ public:
+  // Default constructor
+  bitset_array (void) {}
+
+  // Constructor of <count> zeroed rows of <size> bits
+  bitset_array (siz_t count, siz_t size);
+
+  // Constructor from a list of bitsets of the same size
+  bitset_array (bitset const* bsets, siz_t count);
+
+  // Copy constructor and assignment
+  bitset_array (bitset_array const& ot) { this->copy_from(ot); }
+  bitset_array& operator = (bitset_array const& ot) { return this->copy_from(ot); }
+
+  // Move constructor and assignment
+  bitset_array (bitset_array&& ot) { this->move_from(ot); }
+  bitset_array& operator = (bitset_array&& ot) { return this->move_from(ot); }
+
+  // Destructor
+  ~bitset_array (void) { this->free(); }
+
+  // Copies the contents of a bitset into a row
+  void set (siz_t pos, bitset const& bs);
+
+  // Popcounts of each row against a target
+  void AND_popcount (bitset const& target, siz_t* out) const;
+  void XOR_popcount (bitset const& target, siz_t* out) const;
+
+  // All-pairs kernels, walking tiles of rows and buckets that stay on cache
+  // Hamming distances as a full count x count matrix
+  void hamming (siz_t* out) const;
+  // Hamming distances of the pairs i < j, packed row by row
+  void hamming_upper (siz_t* out) const;
+  // Jaccard distances as a full count x count matrix
+  void jaccard (double* out) const;
+  // Sorted pairs i < j whose Hamming distance is at most threshold
+  std::vector<std::pair<siz_t, siz_t>> hamming_pairs (siz_t threshold) const;
+
+  // Handle to a row, which shares the slab and must not outlive the array
+  bitset operator [] (siz_t pos) { return this->rows_[pos]; }
+  bitset const& operator [] (siz_t pos) const { return this->rows_[pos]; }
+
+  // Getters
+  siz_t count (void) const { return this->count_; }
+  siz_t size (void) const { return this->size_; }
+  siz_t stride (void) const { return this->stride_; }
+  siz_t buckets (void) const { return bitset::count_buckets(this->size()); }
+
+  bck_t const* data (void) const { return this->slab_; }
+  bck_t const* data (siz_t pos) const { return this->slab_ + pos * this->stride(); }
+};
@@ -1,4 +1,8 @@
+#include <cmath>
 #include <iomanip>
+#include <numeric>
+#include <stdexcept>
+#include <unistd.h>
 #include "base.hh"
 #include "macros.hh"
 
@@ -7,6 +11,37 @@ using bck_t = bitset::bck_t;
 // Size type
 using siz_t = bitset::siz_t;
 
+// Number of buckets of a tile on multi-target kernels
+constexpr static siz_t const multi_tile = 256;
+
+// Number of spectrum values of a tile on the Walsh-Hadamard transform
+constexpr static siz_t const walsh_tile = 4096;
+
+// Size of the last level cache in buckets, with a fallback of 32 MiB
+siz_t bitset::llc_buckets (void) {
+  static siz_t const buckets = [] {
+    long bytes = 0;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+
+    if (bytes <= 0) {
+      bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+#endif
+
+    if (bytes <= 0) {
+      bytes = 32l << 20;
+    }
+
+    return static_cast<siz_t>(bytes) / sizeof(bck_t);
+  }();
+
+  return buckets;
+}
+
+siz_t bitset::stream_threshold = std::numeric_limits<siz_t>::max();
+
 // Copy metadata from other bitset
 void bitset::copy_meta (bitset const& ot) {
   this->inverted_ = ot.inverted_;
@@ -24,7 +59,12 @@ void bitset::free (void) {
 
     // Free impl only if this was the last reference
     if (!--this->impl_->ref_) {
-      delete[] this->impl_->data_;
+      if (this->impl_->owner_) {
+        ::operator delete[](
+          this->impl_->data_, std::align_val_t{ bitset::alignment }
+        );
+      }
+
       delete this->impl_;
     }
 
@@ -34,7 +74,7 @@ void bitset::free (void) {
 }
 
 // Copy from another bitset
-bitset& bitset::copy_from (bitset& ot) {
+bitset& bitset::copy_from (bitset const& ot) {
   if (this != &ot) {
     this->free();
     this->copy_meta(ot);
@@ -111,10 +151,269 @@ void bitset::build_combinations (bitset* bsets, siz_t inputs) {
   }
 }
 
+// Constructor from the lowest size bits of the magnitude of an integer
+bitset::bitset (mpz_class const& value, siz_t size) : bitset{ size } {
+  siz_t const limbs = std::min<siz_t>(mpz_size(value.get_mpz_t()), this->buckets());
+
+  if (limbs != 0) {
+    mp_limb_t const* src = mpz_limbs_read(value.get_mpz_t());
+    std::copy_n(src, limbs, this->begin());
+
+    // Drops the bits past size
+    if (limbs == this->buckets()) {
+      this->back() &= this->last_mask();
+    }
+
+    this->fix_popcount();
+  }
+}
+
+// Makes the bitset a writable buffer of size bits
+void bitset::recycle (siz_t size) {
+  if (!this->valid() or this->size() != size or this->impl_->ref_ != 1) {
+    *this = bitset{ size, false, false };
+  }
+
+  // Remove inversion flag
+  this->inverted_ = 0;
+}
+
+// Flips a range of bits
+void bitset::flip (siz_t begin, siz_t end) {
+  if (begin >= end) {
+    return;
+  }
+
+  siz_t const first = bitset::get_ind(begin);
+  siz_t const last = bitset::get_ind(end - 1);
+  bck_t const head = ~bck_t{ 0 } << bitset::get_bit(begin);
+  bck_t const tail = ~bck_t{ 0 } >> (bitset::bits - 1 - bitset::get_bit(end - 1));
+
+  // Flips the masked bits of a bucket, fixing popcount
+  auto const flip_bucket = [ this ] (siz_t pos, bck_t mask) {
+    siz_t const old_pop = util::popcount(this->data(pos));
+    this->data(pos) ^= mask;
+    this->impl_->popcount_ += util::popcount(this->data(pos));
+    this->impl_->popcount_ -= old_pop;
+  };
+
+  if (first == last) {
+    return flip_bucket(first, head & tail);
+  }
+
+  flip_bucket(first, head);
+
+  for (siz_t i = first + 1; i < last; ++i) {
+    flip_bucket(i, ~bck_t{ 0 });
+  }
+
+  flip_bucket(last, tail);
+}
+
+// Fills bitset with random bits set with probability prob
+void bitset::fill_random (double prob, uint64_t seed) {
+  using xoshiro = util::random::xoshiro256;
+  constexpr siz_t lanes = bitset::random_lanes;
+  constexpr siz_t digits = bitset::random_precision;
+
+  // Density as a fixed point fraction of random_precision bits
+  uint64_t const fixed = std::llround(
+    std::clamp(prob, 0.0, 1.0) * static_cast<double>(uint64_t{ 1 } << digits)
+  );
+
+  this->inverted_ = 0;
+
+  if (fixed == 0) {
+    return this->reset();
+
+  } else if (fixed >> digits) {
+    return this->set();
+  }
+
+  // Zeroed digits at the bottom do not change the result
+  siz_t const first = util::ctz(fixed);
+  siz_t const buckets = this->buckets();
+  siz_t pop = 0;
+
+  #pragma omp parallel for schedule(static) reduction(+: pop)
+  for (siz_t c = 0; c < buckets; c += bitset::random_chunk) {
+    siz_t const stop = std::min(c + bitset::random_chunk, buckets);
+    uint64_t s0[lanes], s1[lanes], s2[lanes], s3[lanes];
+
+    // Each chunk has its own stream, so results ignore the thread count
+    uint64_t state = seed ^ (c * UINT64_C(0xD1342543DE82EF95));
+
+    for (siz_t l = 0; l < lanes; ++l) {
+      s0[l] = util::random::splitmix64(state);
+      s1[l] = util::random::splitmix64(state);
+      s2[l] = util::random::splitmix64(state);
+      s3[l] = util::random::splitmix64(state);
+    }
+
+    for (siz_t i = c; i < stop; i += lanes) {
+      bck_t words[lanes] = {};
+
+      // Combines random words from the least to the most significant digit
+      // of the density: OR halves the distance to one and AND the distance
+      // to zero, so the final word has each bit set with probability prob
+      for (siz_t d = first; d < digits; ++d) {
+        bool const one = (fixed >> d) & 1;
+
+        #pragma omp simd
+        for (siz_t l = 0; l < lanes; ++l) {
+          bck_t const rnd = xoshiro::step(s0[l], s1[l], s2[l], s3[l]);
+          words[l] = one ? (words[l] | rnd) : (words[l] & rnd);
+        }
+      }
+
+      for (siz_t l = 0; l < lanes and i + l < stop; ++l) {
+        this->data(i + l) = words[l];
+        pop += util::popcount(words[l]);
+      }
+    }
+  }
+
+  // Fixes the last bucket
+  this->impl_->popcount_ = pop;
+  this->fix_last<true>();
+}
+
 #ifdef NOSIMD
 #pragma message ( "SIMD disabled!" )
 #endif
 
+// Moebius transform in place
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+bitset& bitset::moebius (void) {
+  // Masks of the lower half of each block of 2, 4, ..., 64 bits
+  static constexpr bck_t const lower[] = {
+    make_pattern_v<bck_t, 0, true>, make_pattern_v<bck_t, 1, true>,
+    make_pattern_v<bck_t, 2, true>, make_pattern_v<bck_t, 3, true>,
+    make_pattern_v<bck_t, 4, true>, make_pattern_v<bck_t, 5, true>
+  };
+
+  if (!util::is_pow2(this->size())) {
+    throw std::invalid_argument("Moebius transform needs a truth table of 2^n bits.");
+  }
+
+  siz_t const buckets = this->buckets();
+  siz_t const stages = std::min<siz_t>(util::ctz(this->size()), bitset::bits_shift);
+  bck_t const mask = this->last_mask();
+
+  // Butterflies within each bucket, also dropping the inversion flag
+  #pragma omp parallel for simd schedule(static)
+  for (siz_t i = 0; i < buckets; ++i) {
+    bck_t bck = this->bucket(i) & mask;
+
+    for (siz_t j = 0; j < stages; ++j) {
+      bck ^= (bck & lower[j]) << (siz_t{ 1 } << j);
+    }
+
+    this->data(i) = bck;
+  }
+
+  this->inverted_ = 0;
+
+  // Butterflies between buckets, s buckets apart
+  for (siz_t s = 1; s < buckets; s <<= 1) {
+    #pragma omp parallel for simd schedule(static)
+    for (siz_t i = 0; i < buckets / 2; ++i) {
+      siz_t const j = ((i & ~(s - 1)) << 1) | (i & (s - 1));
+      this->data(j + s) ^= this->data(j);
+    }
+  }
+
+  this->fix_popcount();
+  return *this;
+}
+
+// Walsh-Hadamard spectra of each byte, by value of the byte
+static std::array<std::array<int8_t, 8>, 256> const walsh_bytes = [] () {
+  std::array<std::array<int8_t, 8>, 256> table{};
+
+  for (siz_t v = 0; v < 256; ++v) {
+    for (siz_t u = 0; u < 8; ++u) {
+      int sum = 0;
+
+      for (siz_t x = 0; x < 8; ++x) {
+        sum += (((v >> x) ^ util::popcount(u & x)) & 1) ? -1 : 1;
+      }
+
+      table[v][u] = static_cast<int8_t>(sum);
+    }
+  }
+
+  return table;
+}();
+
+// Walsh-Hadamard spectrum of a truth table
+template <typename T>
+static void walsh_transform (bitset const& bs, T* out) {
+  siz_t const size = bs.size();
+
+  if (!util::is_pow2(size)) {
+    throw std::invalid_argument("Walsh transform needs a truth table of 2^n bits.");
+  }
+
+  siz_t const buckets = bs.buckets();
+  siz_t first = 1;
+
+  // Spectra of each byte, from a lookup table
+  if (size >= 8) {
+    #pragma omp parallel for schedule(static)
+    for (siz_t i = 0; i < buckets; ++i) {
+      bck_t const bck = bs.bucket(i);
+      siz_t const bytes = std::min(bitset::bits, size - i * bitset::bits) / 8;
+
+      for (siz_t b = 0; b < bytes; ++b) {
+        auto const& spectrum = walsh_bytes[(bck >> (b * 8)) & 0xFF];
+        std::copy(spectrum.begin(), spectrum.end(), out + i * bitset::bits + b * 8);
+      }
+    }
+
+    first = 8;
+
+  } else {
+    for (siz_t x = 0; x < size; ++x) {
+      out[x] = bs.get(x) ? -1 : 1;
+    }
+  }
+
+  siz_t const tile = std::min(size, walsh_tile);
+
+  // Butterflies within a tile, each tile staying on cache
+  #pragma omp parallel for schedule(static)
+  for (siz_t t = 0; t < size; t += tile) {
+    for (siz_t s = first; s < tile; s <<= 1) {
+      for (siz_t b = t; b < t + tile; b += 2 * s) {
+        #pragma omp simd
+        for (siz_t k = b; k < b + s; ++k) {
+          T const lo = out[k], hi = out[k + s];
+          out[k] = lo + hi;
+          out[k + s] = lo - hi;
+        }
+      }
+    }
+  }
+
+  // Butterflies spanning several tiles
+  for (siz_t s = std::max(tile, first); s < size; s <<= 1) {
+    #pragma omp parallel for simd schedule(static)
+    for (siz_t i = 0; i < size / 2; ++i) {
+      siz_t const k = ((i & ~(s - 1)) << 1) | (i & (s - 1));
+      T const lo = out[k], hi = out[k + s];
+      out[k] = lo + hi;
+      out[k + s] = lo - hi;
+    }
+  }
+}
+
+// Walsh-Hadamard spectrum
+void bitset::walsh (int32_t* out) const { walsh_transform(*this, out); }
+void bitset::walsh (int64_t* out) const { walsh_transform(*this, out); }
+
 // Bitwise AND of two bitsets
 #ifdef NOSIMD
 __attribute__((target("no-sse")))
@@ -277,6 +576,44 @@ bitset& bitset::MAJ (bitset a, bitset b, bitset c, bitset& out) {
   return out;
 }
 
+// Bitwise ITE of three bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+bitset& bitset::ITE (bitset a, bitset b, bitset c, bitset& out) {
+  constexpr auto equal = compare::equal;
+
+  siz_t const a_p = a.popcount(), a_s = a.size();
+
+  // If a is all zeroes
+  if (a_p == 0) {
+    out = std::move(c);
+
+  // If a is all ones, or b is equal to c
+  } else if (a_p == a_s or b.fast_compare(c) == equal) {
+    out = std::move(b);
+
+  // If a is equal to b
+  } else if (a.fast_compare(b) == equal) {
+    bitset::OR(a, c, out);
+
+  // If a is equal to c
+  } else if (a.fast_compare(c) == equal) {
+    bitset::AND(a, b, out);
+
+  // Evaluate the ITE
+  } else {
+    if (!out.valid() or out.size() < a.size()) {
+      out = bitset{ a.size(), false, false };
+    }
+
+    // Remove inversion flag
+    out.inverted_ = 0;
+    OP_3(a, b, c, out, ite, EMPTY_ARG);
+  }
+  return out;
+}
+
 // Memory aware popcount of bitwise AND between two bitsets
 #ifdef NOSIMD
 __attribute__((target("no-sse")))
@@ -327,6 +664,208 @@ siz_t bitset::AND3_popcount (bitset a, bitset b, bitset c) {
   return out;
 }
 
+// Memory aware popcount of bitwise ITE between three bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::ITE_popcount (bitset a, bitset b, bitset c) {
+  siz_t out = 0;
+  POP_3(a, b, c, out, ite, EMPTY_ARG);
+  return out;
+}
+
+// Uniform crossover of two bitsets given a mask
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+void bitset::crossover (bitset a, bitset b, bitset mask, bitset& c1, bitset& c2) {
+  siz_t const lst = a.buckets() - 1;
+  siz_t pop1 = 0, pop2 = 0;
+
+  c1.recycle(a.size());
+  c2.recycle(a.size());
+
+  // Both children come from swapping the masked differences of the parents
+  #pragma omp parallel for simd schedule(static) reduction(+: pop1, pop2)
+  for (siz_t i = 0; i < lst; ++i) {
+    bck_t const swap = (a.bucket(i) ^ b.bucket(i)) & mask.bucket(i);
+
+    c1.data(i) = a.bucket(i) ^ swap;
+    c2.data(i) = b.bucket(i) ^ swap;
+    pop1 += util::popcount(c1.data(i));
+    pop2 += util::popcount(c2.data(i));
+  }
+
+  bck_t const swap = (a.bucket(lst) ^ b.bucket(lst)) & mask.bucket(lst);
+
+  c1.data(lst) = (a.bucket(lst) ^ swap) & a.last_mask();
+  c2.data(lst) = (b.bucket(lst) ^ swap) & a.last_mask();
+  c1.impl_->popcount_ = pop1 + util::popcount(c1.data(lst));
+  c2.impl_->popcount_ = pop2 + util::popcount(c2.data(lst));
+}
+
+// N-point crossover of two bitsets given the sorted crossover points
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+void bitset::crossover (
+  bitset a, bitset b, siz_t const* points, siz_t n, bitset& c1, bitset& c2
+) {
+  siz_t const lst = a.buckets() - 1;
+  siz_t pop1 = 0, pop2 = 0;
+  bck_t state = 0;
+
+  c1.recycle(a.size());
+  c2.recycle(a.size());
+
+  // Whole buckets between points are spliced, only boundaries are masked
+  for (siz_t i = 0, p = 0; i <= lst; ++i) {
+    bck_t mask = state;
+
+    for (; p < n and bitset::get_ind(points[p]) == i; ++p) {
+      mask ^= ~bck_t{ 0 } << bitset::get_bit(points[p]);
+      state = ~state;
+    }
+
+    bck_t const keep = (i == lst) ? a.last_mask() : ~bck_t{ 0 };
+    bck_t const swap = (a.bucket(i) ^ b.bucket(i)) & mask;
+
+    c1.data(i) = (a.bucket(i) ^ swap) & keep;
+    c2.data(i) = (b.bucket(i) ^ swap) & keep;
+    pop1 += util::popcount(c1.data(i));
+    pop2 += util::popcount(c2.data(i));
+  }
+
+  c1.impl_->popcount_ = pop1;
+  c2.impl_->popcount_ = pop2;
+}
+
+// Memory aware popcounts of bitwise XOR between k pairs of bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::XOR_popcount (
+  bitset const* a, bitset const* b, siz_t k, siz_t* out
+) {
+  if (k == 0) {
+    return 0;
+  }
+
+  siz_t const lst = a[0].buckets() - 1;
+  bck_t const mask = a[0].last_mask();
+
+  for (siz_t p = 0; p < k; ++p) {
+    out[p] = util::popcount((a[p].bucket(lst) ^ b[p].bucket(lst)) & mask);
+  }
+
+  // Every pair is walked on the same tile before moving to the next one
+  #pragma omp parallel for default(shared) schedule(static) reduction(+: out[:k])
+  for (siz_t t = 0; t < lst; t += multi_tile) {
+    siz_t const stop = std::min(t + multi_tile, lst);
+
+    for (siz_t p = 0; p < k; ++p) {
+      siz_t pop = 0;
+
+      #pragma omp simd reduction(+: pop)
+      for (siz_t i = t; i < stop; ++i) {
+        pop += util::popcount(a[p].bucket(i) ^ b[p].bucket(i));
+      }
+
+      out[p] += pop;
+    }
+  }
+
+  return std::accumulate(out, out + k, siz_t{ 0 });
+}
+
+// Memory aware popcounts of bitwise XOR between a bitset and k targets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::XOR_popcount (
+  bitset a, bitset const* targets, siz_t k, siz_t* out
+) {
+  if (k == 0) {
+    return 0;
+  }
+
+  siz_t const lst = a.buckets() - 1;
+  bck_t const mask = a.last_mask();
+
+  for (siz_t p = 0; p < k; ++p) {
+    out[p] = util::popcount((a.bucket(lst) ^ targets[p].bucket(lst)) & mask);
+  }
+
+  // The tile of a stays in cache while the targets stream through
+  #pragma omp parallel for default(shared) schedule(static) reduction(+: out[:k])
+  for (siz_t t = 0; t < lst; t += multi_tile) {
+    siz_t const stop = std::min(t + multi_tile, lst);
+
+    for (siz_t p = 0; p < k; ++p) {
+      siz_t pop = 0;
+
+      #pragma omp simd reduction(+: pop)
+      for (siz_t i = t; i < stop; ++i) {
+        pop += util::popcount(a.bucket(i) ^ targets[p].bucket(i));
+      }
+
+      out[p] += pop;
+    }
+  }
+
+  return std::accumulate(out, out + k, siz_t{ 0 });
+}
+
+// Bounded popcount of bitwise AND between two bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::AND_popcount_bounded (bitset a, bitset b, siz_t limit) {
+  siz_t out = 0;
+  POPB_2(a, b, out, limit, &, EMPTY_ARG);
+  return out;
+}
+
+// Bounded popcount of bitwise OR between two bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::OR_popcount_bounded (bitset a, bitset b, siz_t limit) {
+  siz_t out = 0;
+  POPB_2(a, b, out, limit, |, EMPTY_ARG);
+  return out;
+}
+
+// Bounded popcount of bitwise XOR between two bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::XOR_popcount_bounded (bitset a, bitset b, siz_t limit) {
+  siz_t out = 0;
+  POPB_2(a, b, out, limit, ^, EMPTY_ARG);
+  return out;
+}
+
+// Bounded popcount of bitwise MAJ between three bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::MAJ_popcount_bounded (bitset a, bitset b, bitset c, siz_t limit) {
+  siz_t out = 0;
+  POPB_3(a, b, c, out, limit, maj, EMPTY_ARG);
+  return out;
+}
+
+// Bounded popcount of bitwise AND between three bitsets
+#ifdef NOSIMD
+__attribute__((target("no-sse")))
+#endif
+siz_t bitset::AND3_popcount_bounded (bitset a, bitset b, bitset c, siz_t limit) {
+  siz_t out = 0;
+  POPB_3(a, b, c, out, limit, and3, EMPTY_ARG);
+  return out;
+}
+
 // Generate a copy
 bitset bitset::copy (void) const {
   bitset bs{ this->size(), false, false };
@@ -336,6 +875,25 @@ bitset bitset::copy (void) const {
   return bs;
 }
 
+// Hash of the bits, consistent with equality
+uint64_t bitset::hash (void) const {
+  // Empty bitset
+  if (!(this->valid() and this->buckets())) {
+    return 0;
+  }
+
+  siz_t const last = this->buckets() - 1;
+  uint64_t state = this->size();
+
+  for (siz_t i = 0; i < last; ++i) {
+    state ^= this->bucket(i);
+    state = util::random::rotl(state, 29) * UINT64_C(0x9E3779B97F4A7C15);
+  }
+
+  state ^= this->bucket(last) & this->last_mask();
+  return util::random::splitmix64(state);
+}
+
 // Compare two bitsets
 bool bitset::operator == (bitset const& ot) const {
   // Try fast comparison
@@ -354,7 +912,7 @@ bool bitset::operator == (bitset const& ot) const {
   // Full equality test
   #pragma omp simd reduction(&&: eq)
   for (siz_t i = 0; i < last_pos; ++i) {
-    eq = eq and this->bucket(i) != ot.bucket(i);
+    eq = eq and this->bucket(i) == ot.bucket(i);
   }
 
   return eq and (
@@ -363,6 +921,56 @@ bool bitset::operator == (bitset const& ot) const {
   );
 }
 
+// Converts the bitset to an unsigned integer
+bitset::operator mpz_class (void) const {
+  mpz_class result;
+
+  // Empty bitset
+  if (!(this->valid() and this->buckets())) {
+    return result;
+  }
+
+  siz_t const last = this->buckets() - 1;
+  mp_limb_t* limbs = mpz_limbs_write(result.get_mpz_t(), this->buckets());
+
+  for (siz_t i = 0; i < last; ++i) {
+    limbs[i] = this->bucket(i);
+  }
+
+  limbs[last] = this->bucket(last) & this->last_mask();
+  mpz_limbs_finish(result.get_mpz_t(), this->buckets());
+
+  return result;
+}
+
+// GMP view of a bitset
+bitset::mpz_view::mpz_view (bitset const& bs) : bs_{ bs } {
+  // Invalid bitset, with no buckets to alias
+  if (!bs.valid()) {
+    mpz_init(this->value_);
+    this->owner_ = true;
+    return;
+  }
+
+  siz_t const buckets = bs.buckets();
+  bool const clean = buckets == 0 or
+    (bs.data(buckets - 1) & ~bs.last_mask()) == 0;
+
+  // Aliases the buckets, which GMP reads as limbs
+  if (!bs.inverted() and clean) {
+    mpz_roinit_n(
+      this->value_, reinterpret_cast<mp_limb_t const*>(bs.data()), buckets
+    );
+    return;
+  }
+
+  // Takes over the limbs of a copy otherwise
+  mpz_class copy = static_cast<mpz_class>(bs);
+  mpz_init(this->value_);
+  mpz_swap(this->value_, copy.get_mpz_t());
+  this->owner_ = true;
+}
+
 // Converts the bitset to a hex string
 bitset::operator std::string (void) const {
   // Empty bitset
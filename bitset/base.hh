@@ -2,15 +2,22 @@
 
 #include <algorithm>
 #include <iostream>
+#include <new>
 #include <unordered_map>
 #include <gmp.h>
 #include <gmpxx.h>
 #include <random>
 #include "../util_constexpr.hh"
 #include "../ts_ptr.hh"
+#include "../random.hh"
 #include "macros.hh"
 
 class bitset {
+  friend class bitset_graph;
+  friend class bitset_counter;
+  friend class bitset_array;
+  friend class bitset_bloom;
+
  public:
   // Bucket type
   using bck_t = uintmax_t;
@@ -22,6 +29,14 @@ class bitset {
   // Enumeration of possible outcomes from fast_compare
   enum class compare { equal, different, inverted, unknown };
 
+  // Buckets are exchanged with GMP as limbs
+  static_assert(
+    sizeof(bck_t) == sizeof(mp_limb_t) and GMP_NAIL_BITS == 0,
+    "bitset buckets must match GMP limbs."
+  );
+
+  class mpz_view;
+
  private:
   struct impl {
     // Bitset size
@@ -32,6 +47,8 @@ class bitset {
     bck_t* data_ = nullptr;
     // Ref count
     std::atomic<ref_t> ref_ = 1;
+    // Whether data is freed alongside the impl
+    bool owner_ = true;
   };
 
   // impl object
@@ -42,9 +59,13 @@ class bitset {
   void copy_meta (bitset const& ot);
   void release (void);
 
-  bitset& copy_from (bitset& ot);
+  bitset& copy_from (bitset const& ot);
   bitset& move_from (bitset& ot);
 
+  // Makes the bitset a writable buffer of <size> bits, keeping its storage
+  // when it is not shared
+  void recycle (siz_t size);
+
   void fix_popcount (void) {
     // Recalculate bitset popcount
     this->impl_->popcount_ = bitset::popcount_range(this->begin(), this->end());
@@ -64,6 +85,35 @@ class bitset {
   constexpr static siz_t const bits = std::numeric_limits<bck_t>::digits;
   constexpr static siz_t const bits_shift = static_log2_v<bitset::bits>;
 
+  // Number of buckets scanned between limit checks of bounded popcounts
+  constexpr static siz_t const bound_chunk = 1024;
+
+  // Alignment of the buckets, in bytes (a cache line)
+  constexpr static siz_t const alignment = 64;
+
+  // Buckets fetched ahead of the streaming loops
+  constexpr static siz_t const stream_prefetch = 64;
+  // Minimum number of buckets of results written with non-temporal stores
+  // Streaming is off by default, as it has not been measured faster yet;
+  // llc_buckets() is the intended value to enable it
+  static siz_t stream_threshold;
+
+  // Size of the last level cache, in buckets (detected on first use)
+  static siz_t llc_buckets (void);
+
+  // Whether results of the given number of buckets skip the cache
+  static bool streaming (bitset& out, siz_t buckets) {
+    return STREAM_SUPPORT and buckets >= bitset::stream_threshold and
+      (reinterpret_cast<uintptr_t>(out.data()) % 16) == 0;
+  }
+
+  // Number of bits used to represent the density of random bitsets
+  constexpr static siz_t const random_precision = 32;
+  // Number of buckets drawn from each independent random stream
+  constexpr static siz_t const random_chunk = 1024;
+  // Number of interleaved generators within a random stream
+  constexpr static siz_t const random_lanes = 4;
+
   // Gets the bucket index of a position
   constexpr static siz_t get_ind (siz_t pos) {
     return pos / bitset::bits;
@@ -100,10 +150,17 @@ class bitset {
     return bs;
   }
 
+  // Generates a random bitset whose bits are set with probability prob, with
+  // each chunk of buckets drawn from its own stream derived from seed
+  static bitset random (siz_t size, double prob, uint64_t seed) {
+    bitset bs{ size, false, false };
+    bs.fill_random(prob, seed);
+    return bs;
+  }
+
   // Generates a random bitset
   static bitset random (siz_t size) {
-    std::default_random_engine rnd((std::random_device())());
-    return bitset::random(size, rnd);
+    return bitset::random(size, 0.5, (std::random_device())());
   }
 
   // Bitwise functions
@@ -123,6 +180,92 @@ class bitset {
   static siz_t AND3_popcount (bitset a, bitset b, bitset c);
   static siz_t  ITE_popcount (bitset a, bitset b, bitset c);
 
+  // Crossovers writing both children in a single pass over the parents,
+  // reusing the storage of the children when it is not shared
+  // c1 takes the bits of b where mask is set and c2 the bits of a
+  static void crossover (bitset a, bitset b, bitset mask, bitset& c1, bitset& c2);
+  // Parents are swapped at each of the n sorted points
+  static void crossover (
+    bitset a, bitset b, siz_t const* points, siz_t n, bitset& c1, bitset& c2
+  );
+
+  // Popcounts of the XOR of k pairs of bitsets (or of a single bitset against
+  // k targets) walked together tile by tile, returning the sum of all pairs
+  static siz_t XOR_popcount (bitset const* a, bitset const* b, siz_t k, siz_t* out);
+  static siz_t XOR_popcount (bitset a, bitset const* targets, siz_t k, siz_t* out);
+
+  // Popcounts that stop once the count exceeds limit, returning the exact
+  // count when it is at most limit or any value above limit otherwise
+  static siz_t  AND_popcount_bounded (bitset a, bitset b, siz_t limit);
+  static siz_t   OR_popcount_bounded (bitset a, bitset b, siz_t limit);
+  static siz_t  XOR_popcount_bounded (bitset a, bitset b, siz_t limit);
+  static siz_t  MAJ_popcount_bounded (bitset a, bitset b, bitset c, siz_t limit);
+  static siz_t AND3_popcount_bounded (bitset a, bitset b, bitset c, siz_t limit);
+
+  // Accumulator type of weighted popcounts
+  template <typename W>
+  using wgt_t = std::conditional_t<
+    std::is_floating_point_v<W>, std::common_type_t<W, double>,
+    std::conditional_t<std::is_signed_v<W>, intmax_t, uintmax_t>
+  >;
+
+  // Sum of the weights of the set bits (weights hold one value per bit)
+  template <typename W>
+  static wgt_t<W> weighted_popcount (bitset a, W const* weights) {
+    wgt_t<W> out = 0;
+    WPOP_1(a, weights, out, EMPTY_ARG);
+    return out;
+  }
+
+  // Weighted popcounts of bitwise functions
+  template <typename W>
+  static wgt_t<W> AND_weighted_popcount (bitset a, bitset b, W const* weights) {
+    wgt_t<W> out = 0;
+    WPOP_2(a, b, weights, out, &, EMPTY_ARG);
+    return out;
+  }
+
+  template <typename W>
+  static wgt_t<W> OR_weighted_popcount (bitset a, bitset b, W const* weights) {
+    wgt_t<W> out = 0;
+    WPOP_2(a, b, weights, out, |, EMPTY_ARG);
+    return out;
+  }
+
+  template <typename W>
+  static wgt_t<W> XOR_weighted_popcount (bitset a, bitset b, W const* weights) {
+    wgt_t<W> out = 0;
+    WPOP_2(a, b, weights, out, ^, EMPTY_ARG);
+    return out;
+  }
+
+  template <typename W>
+  static wgt_t<W> MAJ_weighted_popcount (
+    bitset a, bitset b, bitset c, W const* weights
+  ) {
+    wgt_t<W> out = 0;
+    WPOP_3(a, b, c, weights, out, maj, EMPTY_ARG);
+    return out;
+  }
+
+  template <typename W>
+  static wgt_t<W> AND3_weighted_popcount (
+    bitset a, bitset b, bitset c, W const* weights
+  ) {
+    wgt_t<W> out = 0;
+    WPOP_3(a, b, c, weights, out, and3, EMPTY_ARG);
+    return out;
+  }
+
+  template <typename W>
+  static wgt_t<W> ITE_weighted_popcount (
+    bitset a, bitset b, bitset c, W const* weights
+  ) {
+    wgt_t<W> out = 0;
+    WPOP_3(a, b, c, weights, out, ite, EMPTY_ARG);
+    return out;
+  }
+
   // Build an array of all possible inputs' combinations
   static void build_combinations (bitset* bsets, siz_t inputs);
 
@@ -140,13 +283,16 @@ class bitset {
     this->impl_->popcount_ = 0;
     this->impl_->ref_ = 1;
 
+    // Buckets start on a cache line
+    constexpr std::align_val_t align{ bitset::alignment };
+
     if (zeros) {
       // Zeroed bitset
-      this->impl_->data_ = new bck_t[buckets]();
+      this->impl_->data_ = new (align) bck_t[buckets]();
 
     } else {
       // 'Empty' bitset
-      this->impl_->data_ = new bck_t[buckets];
+      this->impl_->data_ = new (align) bck_t[buckets];
 
       if (popcount) {
         this->fix_popcount();
@@ -154,9 +300,12 @@ class bitset {
     }
   }
 
+  // Constructor from the lowest size bits of the magnitude of an integer
+  bitset (mpz_class const& value, siz_t size);
+
   // Copy constructor and assignment
-  bitset (bitset& ot) { this->copy_from(ot); }
-  bitset& operator = (bitset& ot) { return this->copy_from(ot); }
+  bitset (bitset const& ot) { this->copy_from(ot); }
+  bitset& operator = (bitset const& ot) { return this->copy_from(ot); }
 
   // Move constructor and assignment
   bitset (bitset&& ot) { this->move_from(ot); }
@@ -228,6 +377,9 @@ class bitset {
     this->data(ind) ^= sel;
   }
 
+  // Flips a range of bits
+  void flip (siz_t begin, siz_t end);
+
   // Fills bitset with value
   void fill (bck_t value) {
     siz_t const pop = util::popcount(value);
@@ -238,6 +390,19 @@ class bitset {
     this->fix_last<true>();
   }
 
+  // Fills bitset with random bits set with probability prob
+  void fill_random (double prob, uint64_t seed);
+
+  // Transforms of truth tables, whose size must be a power of two
+  // (std::invalid_argument otherwise)
+  // Moebius transform in place, from a truth table to its ANF coefficients
+  // (and back, as it is an involution)
+  bitset& moebius (void);
+
+  // Walsh-Hadamard spectrum, out[u] = sum of (-1)^(f(x) ^ popcount(u & x))
+  void walsh (int32_t* out) const;
+  void walsh (int64_t* out) const;
+
   // Fills a bucket range on bitset with value
   void fill (siz_t begin, siz_t end, bck_t value) {
     // Fixes popcount
@@ -407,9 +572,13 @@ class bitset {
     return *this;
   }
 
+  // Hash of the bits, consistent with equality
+  uint64_t hash (void) const;
+
   // Other operators
   bool operator == (bitset const& ot) const;
   explicit operator std::string (void) const;
+  explicit operator mpz_class (void) const;
 
   // Getters
   siz_t size (void) const { return this->impl_->size_; }
@@ -452,7 +621,40 @@ class bitset {
   }
 };
 
+// Read-only GMP integer over the bits of a bitset, which aliases its buckets
+// unless the bitset is inverted, and must not outlive writes to the bitset
+class bitset::mpz_view {
+ private:
+  // Keeps the buckets alive
+  bitset bs_;
+  // Integer header (or value, when owned)
+  mpz_t value_;
+  // Whether the value holds a copy of the buckets
+  bool owner_ = false;
+
+ public:
+  explicit mpz_view (bitset const& bs);
+
+  mpz_view (mpz_view const&) = delete;
+  mpz_view& operator = (mpz_view const&) = delete;
+
+  ~mpz_view (void) {
+    if (this->owner_) {
+      mpz_clear(this->value_);
+    }
+  }
+
+  mpz_srcptr get (void) const { return this->value_; }
+  operator mpz_srcptr (void) const { return this->get(); }
+};
+
 // Bitset stream operator
 inline std::ostream& operator << (std::ostream& out, bitset const& bs) {
   return out << std::string{ bs };
 }
+
+// Bitset hash, for unordered containers
+template <>
+struct std::hash<bitset> {
+  std::size_t operator () (bitset const& bs) const { return bs.hash(); }
+};
@@ -0,0 +1,152 @@
+#include <cmath>
+#include <limits>
+#include "bloom.hh"
+
+// Bucket type
+using bck_t = bitset_bloom::bck_t;
+// Size type
+using siz_t = bitset_bloom::siz_t;
+// Hash type
+using hsh_t = bitset_bloom::hsh_t;
+
+// Number of bits for count elements at a false positive rate
+siz_t bitset_bloom::optimal_bits (siz_t count, double rate) {
+  double const ln2 = std::log(2.0);
+  double const bits = -static_cast<double>(count) * std::log(rate);
+  return std::max<siz_t>(static_cast<siz_t>(std::ceil(bits / (ln2 * ln2))), 1);
+}
+
+// Number of probes per element for a given amount of bits per element
+siz_t bitset_bloom::optimal_hashes (siz_t bits, siz_t count) {
+  double const ratio = static_cast<double>(bits) / std::max<siz_t>(count, 1);
+  return std::max<siz_t>(std::lround(ratio * std::log(2.0)), 1);
+}
+
+// Constructor with bits (rounded up to whole blocks) and probes per element
+bitset_bloom::bitset_bloom (siz_t bits, siz_t hashes)
+: blocks_{ std::max<siz_t>((bits + block_bits - 1) / block_bits, 1) },
+  hashes_{ std::max<siz_t>(hashes, 1) } {
+  this->bits_ = bitset{ this->blocks_ * block_bits };
+}
+
+// Filter sized for count elements at a false positive rate
+bitset_bloom bitset_bloom::sized (siz_t count, double rate) {
+  siz_t const bits = bitset_bloom::optimal_bits(count, rate);
+  return bitset_bloom{ bits, bitset_bloom::optimal_hashes(bits, count) };
+}
+
+// Copy constructor and assignment, which do not share the bits
+bitset_bloom::bitset_bloom (bitset_bloom const& ot)
+: bits_{ ot.bits_.copy() }, blocks_{ ot.blocks_ }, hashes_{ ot.hashes_ } {}
+
+bitset_bloom& bitset_bloom::operator = (bitset_bloom const& ot) {
+  if (this != &ot) {
+    this->bits_ = ot.bits_.copy();
+    this->blocks_ = ot.blocks_;
+    this->hashes_ = ot.hashes_;
+  }
+
+  return *this;
+}
+
+// Builds the probe mask of a hash within its block
+void bitset_bloom::mask (hsh_t hash, bck_t* out) const {
+  // Probes are derived from a remix, as the block uses the high bits
+  uint64_t state = hash;
+  uint64_t const probe = util::random::splitmix64(state);
+  uint64_t const h1 = probe, h2 = (probe >> 32) | 1;
+
+  std::fill_n(out, block_buckets, 0);
+
+  for (siz_t i = 0; i < this->hashes(); ++i) {
+    siz_t const pos = (h1 + i * h2) % block_bits;
+    out[bitset::get_ind(pos)] |= bck_t{ 1 } << bitset::get_bit(pos);
+  }
+}
+
+// Inserts an element given its hash
+void bitset_bloom::insert (hsh_t hash) {
+  bck_t msk[block_buckets];
+  bck_t* blk = this->bits_.data() + this->block(hash) * block_buckets;
+  siz_t added = 0;
+
+  this->mask(hash, msk);
+
+  #pragma omp simd reduction(+: added)
+  for (siz_t j = 0; j < block_buckets; ++j) {
+    added += util::popcount(msk[j] & ~blk[j]);
+    blk[j] |= msk[j];
+  }
+
+  this->bits_.impl_->popcount_ += added;
+}
+
+// Tests if an element may have been inserted
+bool bitset_bloom::contains (hsh_t hash) const {
+  bck_t msk[block_buckets];
+  bck_t const* blk = this->bits_.data() + this->block(hash) * block_buckets;
+  bck_t missing = 0;
+
+  this->mask(hash, msk);
+
+  #pragma omp simd reduction(|: missing)
+  for (siz_t j = 0; j < block_buckets; ++j) {
+    missing |= msk[j] & ~blk[j];
+  }
+
+  return missing == 0;
+}
+
+// Inserts an element, returning whether it may have been present
+bool bitset_bloom::insert_new (hsh_t hash) {
+  siz_t const old = this->popcount();
+  this->insert(hash);
+  return this->popcount() == old;
+}
+
+// Batch insertion
+void bitset_bloom::insert (hsh_t const* hashes, siz_t n) {
+  for (siz_t i = 0; i < n; ++i) {
+    if (i + batch_prefetch < n) {
+      this->prefetch(hashes[i + batch_prefetch]);
+    }
+
+    this->insert(hashes[i]);
+  }
+}
+
+// Batch query
+void bitset_bloom::contains (hsh_t const* hashes, siz_t n, bool* out) const {
+  #pragma omp parallel for schedule(static)
+  for (siz_t i = 0; i < n; ++i) {
+    if (i + batch_prefetch < n) {
+      this->prefetch(hashes[i + batch_prefetch]);
+    }
+
+    out[i] = this->contains(hashes[i]);
+  }
+}
+
+// Merges the elements of a filter with the same shape
+bitset_bloom& bitset_bloom::operator |= (bitset_bloom const& ot) {
+  bitset::OR(this->bits_, ot.bits_, this->bits_);
+
+  // The OR may share the bits of either filter, which are written in place
+  if (this->bits_.ref() > 1) {
+    this->bits_ = this->bits_.copy();
+  }
+
+  return *this;
+}
+
+// Estimated number of inserted elements, from the fill ratio
+double bitset_bloom::estimate (void) const {
+  double const size = static_cast<double>(this->size());
+  double const fill = static_cast<double>(this->popcount()) / size;
+
+  if (fill >= 1.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  return -size / static_cast<double>(this->hashes()) * std::log1p(-fill);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "base.hh"
+
+// Bloom filter whose probes for an element fall on a single cache line
+class bitset_bloom {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+  // Hash type
+  using hsh_t = uint64_t;
+
+  // Buckets of a block, filling a cache line
+  constexpr static siz_t const block_buckets = bitset::alignment / sizeof(bck_t);
+  // Bits of a block
+  constexpr static siz_t const block_bits = block_buckets * bitset::bits;
+  // Blocks fetched ahead by batch operations
+  constexpr static siz_t const batch_prefetch = 8;
+
+  // Number of bits for <count> elements at a false positive rate <rate>
+  static siz_t optimal_bits (siz_t count, double rate);
+  // Number of probes per element for a given amount of bits per element
+  static siz_t optimal_hashes (siz_t bits, siz_t count);
+
+  // Filter sized for <count> elements at a false positive rate <rate>
+  static bitset_bloom sized (siz_t count, double rate);
+
+ private:
+  // Filter bits, a whole number of blocks
+  bitset bits_;
+  // Number of blocks
+  siz_t blocks_ = 0;
+  // Number of bits probed for each element
+  siz_t hashes_ = 0;
+
+  // Block of a hash
+  siz_t block (hsh_t hash) const {
+    return static_cast<siz_t>(
+      (static_cast<unsigned __int128>(hash) * this->blocks_) >> 64
+    );
+  }
+
+  // Builds the probe mask of a hash within its block
+  void mask (hsh_t hash, bck_t* out) const;
+
+  // Prefetches the block of a hash
+  void prefetch (hsh_t hash) const {
+    __builtin_prefetch(
+      this->bits_.data() + this->block(hash) * block_buckets, 0, 1
+    );
+  }
+
+ public:
+  // Default constructor
+  bitset_bloom (void) {}
+
+  // Constructor with <bits> bits (rounded up to whole blocks) and <hashes>
+  // probes per element
+  bitset_bloom (siz_t bits, siz_t hashes);
+
+  // Copy constructor and assignment
+  bitset_bloom (bitset_bloom const& ot);
+  bitset_bloom& operator = (bitset_bloom const& ot);
+
+  // Move constructor and assignment
+  bitset_bloom (bitset_bloom&& ot) = default;
+  bitset_bloom& operator = (bitset_bloom&& ot) = default;
+
+  // Inserts an element given its hash
+  void insert (hsh_t hash);
+  void insert (bitset const& bs) { this->insert(bs.hash()); }
+
+  // Tests if an element may have been inserted
+  bool contains (hsh_t hash) const;
+  bool contains (bitset const& bs) const { return this->contains(bs.hash()); }
+
+  // Inserts an element, returning whether it may have been present
+  bool insert_new (hsh_t hash);
+  bool insert_new (bitset const& bs) { return this->insert_new(bs.hash()); }
+
+  // Batch operations, prefetching the blocks of the next elements
+  void insert (hsh_t const* hashes, siz_t n);
+  void contains (hsh_t const* hashes, siz_t n, bool* out) const;
+
+  // Merges the elements of a filter with the same shape
+  bitset_bloom& operator |= (bitset_bloom const& ot);
+
+  // Removes all elements
+  void clear (void) { this->bits_.reset(); }
+
+  // Estimated number of inserted elements, from the fill ratio
+  double estimate (void) const;
+
+  // Getters
+  siz_t size (void) const { return this->bits_.size(); }
+  siz_t blocks (void) const { return this->blocks_; }
+  siz_t hashes (void) const { return this->hashes_; }
+  siz_t popcount (void) const { return this->bits_.popcount(); }
+  bitset const& bits (void) const { return this->bits_; }
+};
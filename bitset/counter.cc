@@ -0,0 +1,286 @@
+#include <stdexcept>
+#include "counter.hh"
+#include "macros.hh"
+
+// Bucket type
+using bck_t = bitset_counter::bck_t;
+// Size type
+using siz_t = bitset_counter::siz_t;
+
+// Adds <carry> to the counters in <pl>, starting at plane <level>
+static siz_t ripple (bck_t* pl, siz_t np, siz_t level, bck_t carry) {
+  for (; carry; ++level) {
+    bck_t const next = pl[level] & carry;
+    pl[level] ^= carry;
+    carry = next;
+    np = std::max(np, level + 1);
+  }
+
+  return np;
+}
+
+// Mask of the valid bits of bucket <j> of <bs>
+static bck_t bucket_mask (bitset const& bs, siz_t j) {
+  return (j == bs.buckets() - 1) ? bs.last_mask() : ~bck_t{ 0 };
+}
+
+// Adds bucket <j> of <n> bitsets to the counters in <pl>
+siz_t bitset_counter::accumulate (
+  bitset const* bsets, siz_t n, siz_t j, bck_t mask, bck_t* pl, siz_t np
+) {
+  bck_t ones = 0, twos = 0;
+  siz_t i = 0;
+
+  // Carry-save tree over groups of four, carrying fours into the planes
+  for (; i + 4 <= n; i += 4) {
+    bck_t twos_a, twos_b, fours;
+
+    csa(twos_a, ones, ones, bsets[i + 0].bucket(j), bsets[i + 1].bucket(j));
+    csa(twos_b, ones, ones, bsets[i + 2].bucket(j), bsets[i + 3].bucket(j));
+    csa(fours, twos, twos, twos_a, twos_b);
+
+    np = ripple(pl, np, 2, fours & mask);
+  }
+
+  // Remaining bitsets
+  for (; i < n; ++i) {
+    np = ripple(pl, np, 0, bsets[i].bucket(j) & mask);
+  }
+
+  np = ripple(pl, np, 1, twos & mask);
+  return ripple(pl, np, 0, ones & mask);
+}
+
+// Tests which counters of a bucket are at least <k>
+bck_t bitset_counter::compare (bck_t const* pl, siz_t np, siz_t k) {
+  // k does not fit on the planes, so no counter reaches it
+  if (np < bitset::bits and (k >> np) != 0) {
+    return 0;
+  }
+
+  bck_t gt = 0, eq = ~bck_t{ 0 };
+
+  // Bit-sliced comparison, from the most significant plane
+  for (siz_t p = np; p-- > 0; ) {
+    if ((k >> p) & 1) {
+      eq &= pl[p];
+    } else {
+      gt |= eq & pl[p];
+      eq &= ~pl[p];
+    }
+  }
+
+  return gt | eq;
+}
+
+// Counts, in one pass, how many of <n> bitsets have each position set
+void bitset_counter::counts (bitset const* bsets, siz_t n, siz_t* out) {
+  if (n == 0) {
+    return;
+  }
+
+  siz_t const size = bsets[0].size();
+  siz_t const buckets = bsets[0].buckets();
+
+  #pragma omp parallel for schedule(static)
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t pl[bitset::bits] = {};
+    siz_t const np = bitset_counter::accumulate(
+      bsets, n, j, bucket_mask(bsets[0], j), pl, 0
+    );
+
+    siz_t const first = j * bitset::bits;
+    siz_t const stop = std::min(size - first, bitset::bits);
+
+    for (siz_t b = 0; b < stop; ++b) {
+      siz_t value = 0;
+
+      for (siz_t p = 0; p < np; ++p) {
+        value |= ((pl[p] >> b) & 1) << p;
+      }
+
+      out[first + b] = value;
+    }
+  }
+}
+
+// Builds, in one pass, the positions set on at least <k> of <n> bitsets
+bitset bitset_counter::at_least (bitset const* bsets, siz_t n, siz_t k) {
+  // The size of the result comes from the bitsets
+  if (n == 0) {
+    throw std::invalid_argument("Counting needs at least one bitset.");
+  }
+
+  bitset result{ bsets[0].size(), false, false };
+  siz_t const buckets = result.buckets();
+  siz_t pop = 0;
+
+  #pragma omp parallel for schedule(static) reduction(+: pop)
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t pl[bitset::bits] = {};
+    bck_t const mask = bucket_mask(result, j);
+    siz_t const np = bitset_counter::accumulate(bsets, n, j, mask, pl, 0);
+
+    result.data(j) = bitset_counter::compare(pl, np, k) & mask;
+    pop += util::popcount(result.data(j));
+  }
+
+  result.impl_->popcount_ = pop;
+  return result;
+}
+
+// Release counter storage
+void bitset_counter::release (void) {
+  this->count_ = 0;
+
+  for (bitset& plane : this->planes_) {
+    plane.release();
+  }
+}
+
+// Free counter memory
+void bitset_counter::free (void) {
+  this->count_ = 0;
+
+  for (bitset& plane : this->planes_) {
+    plane.free();
+  }
+}
+
+// Copy metadata from other counter
+void bitset_counter::copy_meta (bitset_counter const& ot) {
+  this->size_ = ot.size_;
+  this->count_ = ot.count_;
+}
+
+// Copy from another counter
+bitset_counter& bitset_counter::copy_from (bitset_counter const& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+
+    for (siz_t p = 0; p < this->planes(); ++p) {
+      this->planes_[p] = ot.planes_[p].copy();
+    }
+  }
+
+  return *this;
+}
+
+// Move from another counter
+bitset_counter& bitset_counter::move_from (bitset_counter& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+
+    for (siz_t p = 0; p < this->planes(); ++p) {
+      this->planes_[p] = std::move(ot.planes_[p]);
+    }
+
+    ot.release();
+  }
+
+  return *this;
+}
+
+// Adds bitsets to the counters
+void bitset_counter::add (bitset const* bsets, siz_t n) {
+  siz_t const old = this->planes();
+  siz_t const np = bitset_counter::planes_for(this->count() + n);
+
+  // Allocates the planes required by the new count beforehand
+  for (siz_t p = old; p < np; ++p) {
+    this->planes_[p] = bitset{ this->size() };
+  }
+
+  if (np == 0) {
+    return;
+  }
+
+  siz_t const buckets = this->planes_[0].buckets();
+
+  #pragma omp parallel for schedule(static)
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t pl[bitset::bits] = {};
+
+    for (siz_t p = 0; p < old; ++p) {
+      pl[p] = this->planes_[p].data(j);
+    }
+
+    bitset_counter::accumulate(
+      bsets, n, j, bucket_mask(this->planes_[0], j), pl, old
+    );
+
+    for (siz_t p = 0; p < np; ++p) {
+      this->planes_[p].data(j) = pl[p];
+    }
+  }
+
+  for (siz_t p = 0; p < np; ++p) {
+    this->planes_[p].fix_popcount();
+  }
+
+  this->count_ += n;
+}
+
+// Count of a single position
+siz_t bitset_counter::at (siz_t pos) const {
+  siz_t value = 0;
+
+  for (siz_t p = 0; p < this->planes(); ++p) {
+    value |= siz_t{ this->planes_[p].get(pos) } << p;
+  }
+
+  return value;
+}
+
+// Counts of all positions
+void bitset_counter::counts (siz_t* out) const {
+  siz_t const np = this->planes();
+
+  if (np == 0) {
+    std::fill(out, out + this->size(), 0);
+    return;
+  }
+
+  siz_t const buckets = this->planes_[0].buckets();
+
+  #pragma omp parallel for schedule(static)
+  for (siz_t j = 0; j < buckets; ++j) {
+    siz_t const first = j * bitset::bits;
+    siz_t const stop = std::min(this->size() - first, bitset::bits);
+
+    for (siz_t b = 0; b < stop; ++b) {
+      siz_t value = 0;
+
+      for (siz_t p = 0; p < np; ++p) {
+        value |= ((this->planes_[p].data(j) >> b) & 1) << p;
+      }
+
+      out[first + b] = value;
+    }
+  }
+}
+
+// Positions set on at least <k> of the added bitsets
+bitset bitset_counter::at_least (siz_t k) const {
+  bitset result{ this->size(), false, false };
+  siz_t const np = this->planes();
+  siz_t const buckets = result.buckets();
+  siz_t pop = 0;
+
+  #pragma omp parallel for schedule(static) reduction(+: pop)
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t pl[bitset::bits];
+
+    for (siz_t p = 0; p < np; ++p) {
+      pl[p] = this->planes_[p].data(j);
+    }
+
+    result.data(j) = bitset_counter::compare(pl, np, k) & bucket_mask(result, j);
+    pop += util::popcount(result.data(j));
+  }
+
+  result.impl_->popcount_ = pop;
+  return result;
+}
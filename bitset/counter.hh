@@ -0,0 +1,98 @@
+#pragma once
+
+#include "base.hh"
+
+// Bit-sliced counters of how many bitsets have each position set
+class bitset_counter {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+
+  // Number of planes required to count up to <value>
+  constexpr static siz_t planes_for (siz_t value) {
+    siz_t result = 0;
+
+    for (; value; value >>= 1) {
+      ++result;
+    }
+
+    return result;
+  }
+
+  // Adds bucket <j> of <n> bitsets to the counters in <pl>
+  static siz_t accumulate (
+    bitset const* bsets, siz_t n, siz_t j, bck_t mask, bck_t* pl, siz_t np
+  );
+
+  // Tests which counters of a bucket are at least <k>
+  static bck_t compare (bck_t const* pl, siz_t np, siz_t k);
+
+  // Counts, in one pass, how many of <n> bitsets have each position set
+  static void counts (bitset const* bsets, siz_t n, siz_t* out);
+
+  // Builds, in one pass, the positions set on at least <k> of <n> bitsets
+  // (std::invalid_argument if n is zero)
+  static bitset at_least (bitset const* bsets, siz_t n, siz_t k);
+
+  // Builds, in one pass, the positions set on most of <n> bitsets
+  static bitset majority (bitset const* bsets, siz_t n) {
+    return bitset_counter::at_least(bsets, n, (n / 2) + 1);
+  }
+
+ private:
+  // Number of bits of each counter row
+  siz_t size_ = 0;
+  // Number of bitsets added
+  siz_t count_ = 0;
+  // Bit-planes, least significant first
+  bitset planes_[bitset::bits];
+
+  void release (void);
+  void free (void);
+
+  void copy_meta (bitset_counter const& ot);
+  bitset_counter& copy_from (bitset_counter const& ot);
+  bitset_counter& move_from (bitset_counter& ot);
+
+ public:
+  // Default constructor
+  bitset_counter (void) {}
+
+  // Constructor
+  explicit bitset_counter (siz_t size) : size_{ size } {}
+
+  // Copy constructor and assignment
+  bitset_counter (bitset_counter const& ot) { this->copy_from(ot); }
+  bitset_counter& operator = (bitset_counter const& ot) { return this->copy_from(ot); }
+
+  // Move constructor and assignment
+  bitset_counter (bitset_counter&& ot) { this->move_from(ot); }
+  bitset_counter& operator = (bitset_counter&& ot) { return this->move_from(ot); }
+
+  // Adds bitsets to the counters
+  void add (bitset const* bsets, siz_t n);
+  void add (bitset const& bs) { this->add(&bs, 1); }
+
+  // Clears all counters
+  void reset (void) { this->free(); }
+
+  // Count of a single position
+  siz_t at (siz_t pos) const;
+
+  // Counts of all positions
+  void counts (siz_t* out) const;
+
+  // Positions set on at least <k> of the added bitsets
+  bitset at_least (siz_t k) const;
+
+  // Positions set on most of the added bitsets
+  bitset majority (void) const { return this->at_least((this->count() / 2) + 1); }
+
+  // Getters
+  siz_t size (void) const { return this->size_; }
+  siz_t count (void) const { return this->count_; }
+  siz_t planes (void) const { return bitset_counter::planes_for(this->count()); }
+  bitset const& plane (siz_t pos) const { return this->planes_[pos]; }
+};
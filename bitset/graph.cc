@@ -0,0 +1,298 @@
+#include "graph.hh"
+
+// Bucket type
+using bck_t = bitset_graph::bck_t;
+// Size type
+using siz_t = bitset_graph::siz_t;
+
+// Number of buckets of a push tile
+constexpr static siz_t const push_tile = 64;
+
+// Constructor of a graph without edges
+bitset_graph::bitset_graph (siz_t vertices) : vertices_{ vertices } {
+  this->alloc();
+
+  for (siz_t i = 0; i < vertices; ++i) {
+    this->out_[i] = bitset{ vertices };
+    this->in_[i] = bitset{ vertices };
+  }
+}
+
+// Allocate rows
+void bitset_graph::alloc (void) {
+  this->out_ = new bitset[this->vertices()];
+  this->in_ = new bitset[this->vertices()];
+}
+
+// Release graph storage
+void bitset_graph::release (void) {
+  this->vertices_ = 0;
+  this->out_ = nullptr;
+  this->in_ = nullptr;
+}
+
+// Free graph memory
+void bitset_graph::free (void) {
+  delete[] this->out_;
+  delete[] this->in_;
+  this->release();
+}
+
+// Copy metadata from other graph
+void bitset_graph::copy_meta (bitset_graph const& ot) {
+  this->vertices_ = ot.vertices_;
+  this->alpha_ = ot.alpha_;
+  this->beta_ = ot.beta_;
+}
+
+// Copy from another graph
+bitset_graph& bitset_graph::copy_from (bitset_graph const& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+    this->alloc();
+
+    for (siz_t i = 0; i < this->vertices(); ++i) {
+      this->out_[i] = ot.out_[i].copy();
+      this->in_[i] = ot.in_[i].copy();
+    }
+  }
+
+  return *this;
+}
+
+// Move from another graph
+bitset_graph& bitset_graph::move_from (bitset_graph& ot) {
+  if (this != &ot) {
+    this->free();
+    this->copy_meta(ot);
+    this->out_ = ot.out_;
+    this->in_ = ot.in_;
+    ot.release();
+  }
+
+  return *this;
+}
+
+// Number of edges
+siz_t bitset_graph::edges (void) const {
+  siz_t result = 0;
+
+  for (siz_t i = 0; i < this->vertices(); ++i) {
+    result += this->out_[i].popcount();
+  }
+
+  return result;
+}
+
+// Rebuilds the in-neighborhood rows from the out-neighborhood ones
+void bitset_graph::transpose (void) {
+  siz_t const buckets = bitset::count_buckets(this->vertices());
+
+  // Each thread owns the in-rows of a bucket of vertices
+  #pragma omp parallel for schedule(dynamic)
+  for (siz_t j = 0; j < buckets; ++j) {
+    siz_t const first = j * bitset::bits;
+    siz_t const last = std::min(first + bitset::bits, this->vertices());
+
+    for (siz_t v = first; v < last; ++v) {
+      this->in_[v].reset();
+    }
+
+    for (siz_t u = 0; u < this->vertices(); ++u) {
+      bck_t bck = this->out_[u].bucket(j);
+
+      // Visits each out-neighbor of u inside this bucket
+      while (bck) {
+        this->in_[first + util::ctz(bck)].set(u);
+        bck &= bck - 1;
+      }
+    }
+  }
+}
+
+// Expands the next frontier from the current one through out-rows
+void bitset_graph::push (
+  std::vector<siz_t> const& frontier, bitset& visited, bitset& next
+) const {
+  siz_t const buckets = next.buckets();
+
+  // Tiles the output so each tile of next stays in cache while rows stream
+  #pragma omp parallel for schedule(static)
+  for (siz_t t = 0; t < buckets; t += push_tile) {
+    siz_t const stop = std::min(t + push_tile, buckets);
+
+    for (siz_t j = t; j < stop; ++j) {
+      next.data(j) = 0;
+    }
+
+    for (siz_t const u : frontier) {
+      bitset const& row = this->out_[u];
+
+      #pragma omp simd
+      for (siz_t j = t; j < stop; ++j) {
+        next.data(j) |= row.bucket(j);
+      }
+    }
+
+    for (siz_t j = t; j < stop; ++j) {
+      next.data(j) &= ~visited.data(j);
+      visited.data(j) |= next.data(j);
+    }
+  }
+}
+
+// Expands the next frontier by testing unvisited in-rows against it
+void bitset_graph::pull (
+  bitset const& frontier, bitset& visited, bitset& next
+) const {
+  siz_t const buckets = next.buckets();
+  siz_t const last = buckets - 1;
+
+  // Each thread owns a bucket of vertices
+  #pragma omp parallel for schedule(dynamic)
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t const mask = (j == last) ? next.last_mask() : ~bck_t{ 0 };
+    bck_t unvisited = ~visited.data(j) & mask;
+    bck_t found = 0;
+
+    while (unvisited) {
+      siz_t const bit = util::ctz(unvisited);
+      bitset const& row = this->in_[j * bitset::bits + bit];
+
+      // Stops on the first parent found on the frontier
+      for (siz_t k = 0; k < buckets; ++k) {
+        if (row.bucket(k) & frontier.data(k)) {
+          found |= bck_t{ 1 } << bit;
+          break;
+        }
+      }
+
+      unvisited &= unvisited - 1;
+    }
+
+    next.data(j) = found;
+    visited.data(j) |= found;
+  }
+}
+
+// Breadth-first search from a set of sources, returning reached vertices
+bitset bitset_graph::bfs (bitset const& sources, siz_t* distance) const {
+  siz_t const size = this->vertices();
+  siz_t const buckets = bitset::count_buckets(size);
+
+  if (distance != nullptr) {
+    std::fill(distance, distance + size, bitset_graph::unreachable);
+  }
+
+  if (size == 0) {
+    return bitset{ 0 };
+  }
+
+  bitset visited{ size, false, false };
+  bitset frontier{ size, false, false };
+  bitset next{ size, false, false };
+
+  std::vector<siz_t> list;
+  list.reserve(size);
+
+  // Edges leaving the frontier and edges entering unvisited vertices
+  siz_t edges_f = 0;
+  siz_t edges_u = this->edges();
+
+  // Collects the vertices of a frontier and updates edge counters
+  auto collect = [ & ] (bitset const& bs, siz_t level) {
+    list.clear();
+
+    for (siz_t j = 0; j < buckets; ++j) {
+      bck_t bck = bs.data(j);
+
+      while (bck) {
+        siz_t const v = j * bitset::bits + util::ctz(bck);
+        list.emplace_back(v);
+        bck &= bck - 1;
+      }
+    }
+
+    edges_f = 0;
+
+    for (siz_t const v : list) {
+      edges_f += this->out_[v].popcount();
+      edges_u -= this->in_[v].popcount();
+
+      if (distance != nullptr) {
+        distance[v] = level;
+      }
+    }
+  };
+
+  for (siz_t j = 0; j < buckets; ++j) {
+    bck_t const mask = (j == buckets - 1) ? sources.last_mask() : ~bck_t{ 0 };
+    visited.data(j) = frontier.data(j) = sources.bucket(j) & mask;
+  }
+
+  collect(frontier, 0);
+  bool pull = false;
+
+  for (siz_t level = 1; !list.empty(); ++level) {
+    // Top-down while the frontier is light, bottom-up while it is heavy
+    if (!pull) {
+      pull = edges_f > edges_u / this->alpha();
+    } else {
+      pull = list.size() >= size / this->beta();
+    }
+
+    if (pull) {
+      this->pull(frontier, visited, next);
+    } else {
+      this->push(list, visited, next);
+    }
+
+    std::swap(frontier, next);
+    collect(frontier, level);
+  }
+
+  visited.fix_popcount();
+  return visited;
+}
+
+// Breadth-first search from a single source
+bitset bitset_graph::bfs (siz_t source, siz_t* distance) const {
+  bitset sources{ this->vertices() };
+  sources.set(source);
+  return this->bfs(sources, distance);
+}
+
+// Transitive closure (bit v of row u is set if v is reachable from u)
+bitset_graph bitset_graph::closure (void) const {
+  bitset_graph result{ *this };
+  siz_t const size = result.vertices();
+  siz_t const buckets = bitset::count_buckets(size);
+
+  // Warshall's algorithm, with each row update done a bucket at a time
+  for (siz_t k = 0; k < size; ++k) {
+    bitset const& row_k = result.out_[k];
+
+    #pragma omp parallel for schedule(static)
+    for (siz_t i = 0; i < size; ++i) {
+      if (i == k or !result.out_[i].get(k)) {
+        continue;
+      }
+
+      bitset& row_i = result.out_[i];
+
+      #pragma omp simd
+      for (siz_t j = 0; j < buckets; ++j) {
+        row_i.data(j) |= row_k.data(j);
+      }
+    }
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (siz_t i = 0; i < size; ++i) {
+    result.out_[i].fix_popcount();
+  }
+
+  result.transpose();
+  return result;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include "base.hh"
+
+// Directed graph stored as bitset adjacency rows
+class bitset_graph {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+
+  // Distance assigned to vertices not reached by a search
+  constexpr static siz_t const unreachable = std::numeric_limits<siz_t>::max();
+
+ private:
+  // Number of vertices
+  siz_t vertices_ = 0;
+  // Out-neighborhood rows (bit v of row u is set if u -> v)
+  bitset* out_ = nullptr;
+  // In-neighborhood rows (bit u of row v is set if u -> v)
+  bitset* in_ = nullptr;
+  // Switches to pull when frontier edges exceed unexplored edges / alpha
+  siz_t alpha_ = 14;
+  // Switches back to push when the frontier is smaller than vertices / beta
+  siz_t beta_ = 24;
+
+  void alloc (void);
+  void release (void);
+  void free (void);
+
+  void copy_meta (bitset_graph const& ot);
+  bitset_graph& copy_from (bitset_graph const& ot);
+  bitset_graph& move_from (bitset_graph& ot);
+
+  // Rebuilds the in-neighborhood rows from the out-neighborhood ones
+  void transpose (void);
+
+  // Expands the next frontier from the current one through out-rows
+  void push (
+    std::vector<siz_t> const& frontier, bitset& visited, bitset& next
+  ) const;
+
+  // Expands the next frontier by testing unvisited in-rows against it
+  void pull (bitset const& frontier, bitset& visited, bitset& next) const;
+
+ public:
+  // Default constructor
+  bitset_graph (void) {}
+
+  // Constructor of a graph without edges
+  explicit bitset_graph (siz_t vertices);
+
+  // Copy constructor and assignment
+  bitset_graph (bitset_graph const& ot) { this->copy_from(ot); }
+  bitset_graph& operator = (bitset_graph const& ot) { return this->copy_from(ot); }
+
+  // Move constructor and assignment
+  bitset_graph (bitset_graph&& ot) { this->move_from(ot); }
+  bitset_graph& operator = (bitset_graph&& ot) { return this->move_from(ot); }
+
+  // Destructor
+  ~bitset_graph (void) { this->free(); }
+
+  // Edge manipulation
+  void add_edge (siz_t from, siz_t to) {
+    this->out_[from].set(to);
+    this->in_[to].set(from);
+  }
+
+  void remove_edge (siz_t from, siz_t to) {
+    this->out_[from].reset(to);
+    this->in_[to].reset(from);
+  }
+
+  bool has_edge (siz_t from, siz_t to) const {
+    return this->out_[from].get(to);
+  }
+
+  // Breadth-first search from a set of sources, returning reached vertices
+  bitset bfs (bitset const& sources, siz_t* distance = nullptr) const;
+
+  // Breadth-first search from a single source
+  bitset bfs (siz_t source, siz_t* distance = nullptr) const;
+
+  // Transitive closure (bit v of row u is set if v is reachable from u)
+  bitset_graph closure (void) const;
+
+  // Getters
+  siz_t vertices (void) const { return this->vertices_; }
+  bitset const& out (siz_t vertex) const { return this->out_[vertex]; }
+  bitset const& in (siz_t vertex) const { return this->in_[vertex]; }
+
+  // Number of edges
+  siz_t edges (void) const;
+
+  // Direction switching parameters
+  siz_t& alpha (void) { return this->alpha_; }
+  siz_t const& alpha (void) const { return this->alpha_; }
+  siz_t& beta (void) { return this->beta_; }
+  siz_t const& beta (void) const { return this->beta_; }
+};
@@ -0,0 +1,171 @@
+#include <limits>
+#include "lsh.hh"
+
+// Bucket type
+using bck_t = bitset_lsh::bck_t;
+// Size type
+using siz_t = bitset_lsh::siz_t;
+// Hash key type
+using hsh_t = bitset_lsh::hsh_t;
+
+// Hash of a position under a salt, used as a random permutation by MinHash
+static uint64_t min_hash (uint64_t salt, siz_t pos) {
+  uint64_t state = salt ^ pos;
+  return util::random::splitmix64(state);
+}
+
+// Constructor
+bitset_lsh::bitset_lsh (
+  siz_t size, metric mtr, siz_t tables, siz_t hashes, uint64_t seed
+) : metric_{ mtr }, size_{ size }, hashes_{ std::min(hashes, max_hashes) },
+    tables_(tables) {
+  util::random::xoshiro256 rnd{ seed };
+  this->params_.resize(tables * this->hashes());
+
+  // Sampled positions draw from the whole bitset, salts are raw outputs
+  uint64_t const range = (this->type() == metric::hamming) ? size : 0;
+
+  for (uint64_t& param : this->params_) {
+    param = range ? rnd() % range : rnd();
+  }
+}
+
+// Computes the key of a bitset for each table
+void bitset_lsh::keys (bitset const& bs, hsh_t* out) const {
+  siz_t const tables = this->tables();
+  siz_t const hashes = this->hashes();
+
+  // Bit-sampling: concatenates the sampled bits
+  if (this->type() == metric::hamming) {
+    for (siz_t t = 0; t < tables; ++t) {
+      uint64_t const* pos = this->params_.data() + t * hashes;
+      hsh_t key = 0;
+
+      for (siz_t h = 0; h < hashes; ++h) {
+        key |= hsh_t{ bs.get(pos[h]) } << h;
+      }
+
+      out[t] = key;
+    }
+
+    return;
+  }
+
+  // MinHash: a single pass over the set bits updates every minimum
+  std::vector<uint64_t> mins(this->params_.size(), ~uint64_t{ 0 });
+  siz_t const last = bs.buckets() - 1;
+
+  for (siz_t i = 0; i <= last; ++i) {
+    bck_t bck = bs.bucket(i);
+
+    if (i == last) {
+      bck &= bs.last_mask();
+    }
+
+    for (; bck; bck &= bck - 1) {
+      siz_t const pos = i * bitset::bits + util::ctz(bck);
+
+      for (siz_t j = 0; j < mins.size(); ++j) {
+        mins[j] = std::min(mins[j], min_hash(this->params_[j], pos));
+      }
+    }
+  }
+
+  // Combines the minima of each table
+  for (siz_t t = 0; t < tables; ++t) {
+    uint64_t state = t;
+
+    for (siz_t h = 0; h < hashes; ++h) {
+      state ^= mins[t * hashes + h];
+      state = util::random::splitmix64(state);
+    }
+
+    out[t] = state;
+  }
+}
+
+// Exact distance between a bitset and an entry, or a value above limit
+double bitset_lsh::distance (bitset const& bs, siz_t id, double limit) const {
+  bitset const& entry = this->entries_[id];
+
+  if (this->type() == metric::hamming) {
+    siz_t const bound = (limit < static_cast<double>(this->size()))
+      ? static_cast<siz_t>(limit) : this->size();
+
+    return static_cast<double>(bitset::XOR_popcount_bounded(bs, entry, bound));
+  }
+
+  siz_t const inter = bitset::AND_popcount(bs, entry);
+  siz_t const uni = bs.popcount() + entry.popcount() - inter;
+
+  return uni ? 1.0 - static_cast<double>(inter) / static_cast<double>(uni) : 0.0;
+}
+
+// Adds a bitset to the index
+siz_t bitset_lsh::insert (bitset const& bs) {
+  siz_t const id = this->count();
+  std::vector<hsh_t> keys(this->tables());
+
+  this->keys(bs, keys.data());
+  this->entries_.emplace_back(bs);
+
+  for (siz_t t = 0; t < this->tables(); ++t) {
+    this->tables_[t][keys[t]].emplace_back(id);
+  }
+
+  return id;
+}
+
+// Approximate k nearest entries, ranked by their exact distance
+std::vector<bitset_lsh::match> bitset_lsh::query (
+  bitset const& bs, siz_t k
+) const {
+  if (k == 0) {
+    return {};
+  }
+
+  std::vector<hsh_t> keys(this->tables());
+  std::vector<siz_t> candidates;
+
+  this->keys(bs, keys.data());
+
+  for (siz_t t = 0; t < this->tables(); ++t) {
+    auto const it = this->tables_[t].find(keys[t]);
+
+    if (it != this->tables_[t].end()) {
+      candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(
+    std::unique(candidates.begin(), candidates.end()), candidates.end()
+  );
+
+  // Keeps the k best as a max-heap, bounding the popcounts by the worst
+  auto const worse = [] (match const& a, match const& b) {
+    return a.distance < b.distance or (a.distance == b.distance and a.id < b.id);
+  };
+
+  std::vector<match> best;
+  best.reserve(k + 1);
+
+  for (siz_t const id : candidates) {
+    double const limit = (best.size() < k)
+      ? std::numeric_limits<double>::max() : best.front().distance;
+    double const dist = this->distance(bs, id, limit);
+
+    if (best.size() < k) {
+      best.push_back({ id, dist });
+      std::push_heap(best.begin(), best.end(), worse);
+
+    } else if (dist < limit) {
+      std::pop_heap(best.begin(), best.end(), worse);
+      best.back() = { id, dist };
+      std::push_heap(best.begin(), best.end(), worse);
+    }
+  }
+
+  std::sort_heap(best.begin(), best.end(), worse);
+  return best;
+}
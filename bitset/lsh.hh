@@ -0,0 +1,71 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "base.hh"
+
+// Locality-sensitive hashing index for approximate nearest-neighbor search
+class bitset_lsh {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+  // Hash key type
+  using hsh_t = uint64_t;
+
+  // Distances supported by the index
+  // Hamming uses bit-sampling signatures, Jaccard uses MinHash signatures
+  enum class metric { hamming, jaccard };
+
+  // Result of a query
+  struct match {
+    siz_t id;
+    double distance;
+  };
+
+  // Maximum number of hashes concatenated on each key
+  constexpr static siz_t const max_hashes = 64;
+
+ private:
+  // Distance used by the index
+  metric metric_;
+  // Number of bits of the indexed bitsets
+  siz_t size_;
+  // Number of hashes concatenated on each key
+  siz_t hashes_;
+  // Sampled positions (hamming) or hash salts (jaccard), hashes_ per table
+  std::vector<uint64_t> params_;
+  // Hash tables, mapping keys to entry ids
+  std::vector<std::unordered_map<hsh_t, std::vector<siz_t>>> tables_;
+  // Indexed bitsets, sharing storage with the inserted ones
+  std::vector<bitset> entries_;
+
+  // Computes the key of a bitset for each table
+  void keys (bitset const& bs, hsh_t* out) const;
+
+  // Exact distance between a bitset and an entry, or a value above limit
+  double distance (bitset const& bs, siz_t id, double limit) const;
+
+ public:
+  // Constructor for bitsets of <size> bits, with <tables> tables whose keys
+  // concatenate <hashes> hashes each
+  bitset_lsh (
+    siz_t size, metric mtr, siz_t tables, siz_t hashes, uint64_t seed = 0
+  );
+
+  // Adds a bitset to the index, returning its id
+  siz_t insert (bitset const& bs);
+
+  // Approximate k nearest entries, ranked by their exact distance
+  // Only entries sharing a key with the query are considered
+  std::vector<match> query (bitset const& bs, siz_t k) const;
+
+  // Getters
+  siz_t size (void) const { return this->size_; }
+  siz_t count (void) const { return this->entries_.size(); }
+  siz_t tables (void) const { return this->tables_.size(); }
+  siz_t hashes (void) const { return this->hashes_; }
+  metric type (void) const { return this->metric_; }
+  bitset const& at (siz_t id) const { return this->entries_[id]; }
+};
@@ -2,20 +2,66 @@
 
 #include "../util_constexpr.hh"
 
+// Non-temporal stores, used for results that do not fit on the cache
+#if defined(__SSE2__) and defined(__x86_64__) and !defined(NOSIMD)
+#include <immintrin.h>
+#define STREAM_SUPPORT true
+#define STREAM_STORE(ptr, lo, hi) _mm_stream_si128( \
+  reinterpret_cast<__m128i*>(ptr), \
+  _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo)) \
+)
+#define STREAM_FENCE() _mm_sfence()
+#else
+#define STREAM_SUPPORT false
+#define STREAM_STORE(ptr, lo, hi) ((ptr)[0] = (lo), (ptr)[1] = (hi))
+#define STREAM_FENCE()
+#endif
+
+#define STREAM_PREFETCH(bs, i) \
+  __builtin_prefetch(bs.data() + (i) + bitset::stream_prefetch, 0, 0)
+
 #define EVAL_2(a, b, op, una, i) una(a.bucket(i) op b.bucket(i))
 
 #define OP_BLOCK(out, i) \
   _pop += util::popcount(_bck); \
   out.data(i) = _bck
 
+// Evaluates and writes a pair of buckets bypassing the cache
+#define OP_STREAM_BLOCK(out, i, lo, hi) \
+  bitset::bck_t const _lo = lo; \
+  bitset::bck_t const _hi = hi; \
+  _pop += util::popcount(_lo) + util::popcount(_hi); \
+  STREAM_STORE(out.data() + (i), _lo, _hi)
+
 #define OP_2(a, b, out, op, una) { \
   bitset::siz_t const _lst = a.buckets() - 1; \
   bitset::siz_t _pop = 0; \
   \
-  _Pragma("omp parallel for simd default(shared) schedule(static) reduction(+: _pop)") \
-  for (bitset::siz_t i = 0; i < _lst; ++i) { \
-    bitset::bck_t _bck = EVAL_2(a, b, op, una, i); \
-    OP_BLOCK(out, i); \
+  if (bitset::streaming(out, _lst)) { \
+    bitset::siz_t const _pairs = _lst & ~bitset::siz_t{ 1 }; \
+    \
+    _Pragma("omp parallel default(shared) reduction(+: _pop)") \
+    { \
+      _Pragma("omp for schedule(static) nowait") \
+      for (bitset::siz_t i = 0; i < _pairs; i += 2) { \
+        STREAM_PREFETCH(a, i); \
+        STREAM_PREFETCH(b, i); \
+        OP_STREAM_BLOCK(out, i, EVAL_2(a, b, op, una, i), EVAL_2(a, b, op, una, i + 1)); \
+      } \
+      \
+      STREAM_FENCE(); \
+    } \
+    \
+    for (bitset::siz_t i = _pairs; i < _lst; ++i) { \
+      bitset::bck_t _bck = EVAL_2(a, b, op, una, i); \
+      OP_BLOCK(out, i); \
+    } \
+  } else { \
+    _Pragma("omp parallel for simd default(shared) schedule(static) reduction(+: _pop)") \
+    for (bitset::siz_t i = 0; i < _lst; ++i) { \
+      bitset::bck_t _bck = EVAL_2(a, b, op, una, i); \
+      OP_BLOCK(out, i); \
+    } \
   } \
   \
   bitset::bck_t _bck = EVAL_2(a, b, op, una, _lst) & a.last_mask(); \
@@ -35,9 +81,91 @@
   out = _pop + util::popcount(EVAL_2(a, b, op, una, _lst) & a.last_mask()); \
 }
 
+// Popcount that gives up once the running count exceeds a limit
+#define POPB_2(a, b, out, limit, op, una) { \
+  bitset::siz_t const _lst = a.buckets() - 1; \
+  bitset::siz_t const _lim = limit; \
+  bitset::siz_t _pop = 0; \
+  \
+  _Pragma("omp parallel for default(shared) schedule(dynamic)") \
+  for (bitset::siz_t _c = 0; _c < _lst; _c += bitset::bound_chunk) { \
+    bitset::siz_t _now; \
+    _Pragma("omp atomic read") \
+    _now = _pop; \
+    \
+    if (_now > _lim) { \
+      continue; \
+    } \
+    \
+    bitset::siz_t const _end = std::min(_c + bitset::bound_chunk, _lst); \
+    bitset::siz_t _cnt = 0; \
+    \
+    _Pragma("omp simd reduction(+: _cnt)") \
+    for (bitset::siz_t i = _c; i < _end; ++i) { \
+      _cnt += util::popcount(EVAL_2(a, b, op, una, i)); \
+    } \
+    \
+    _Pragma("omp atomic update") \
+    _pop += _cnt; \
+  } \
+  \
+  out = _pop + util::popcount(EVAL_2(a, b, op, una, _lst) & a.last_mask()); \
+}
+
+#define EVAL_1(a, una, i) una(a.bucket(i))
+
+// Adds the weights of the set bits of a bucket, expanding each bit to a mask
+#define WPOP_BLOCK(bck, w, i, count) \
+  if (bck != 0) { \
+    auto const* _w = (w) + (i) * bitset::bits; \
+    \
+    _Pragma("omp simd reduction(+: _acc)") \
+    for (bitset::siz_t _b = 0; _b < (count); ++_b) { \
+      _acc += ((bck >> _b) & 1) ? _w[_b] : 0; \
+    } \
+  }
+
+#define WPOP_1(a, w, out, una) { \
+  bitset::siz_t const _lst = a.buckets() - 1; \
+  auto _acc = out; \
+  \
+  _Pragma("omp parallel for default(shared) schedule(static) reduction(+: _acc)") \
+  for (bitset::siz_t i = 0; i < _lst; ++i) { \
+    bitset::bck_t const _bck = EVAL_1(a, una, i); \
+    WPOP_BLOCK(_bck, w, i, bitset::bits); \
+  } \
+  \
+  bitset::bck_t const _bck = EVAL_1(a, una, _lst); \
+  WPOP_BLOCK(_bck, w, _lst, a.last_bits()); \
+  out = _acc; \
+}
+
+#define WPOP_2(a, b, w, out, op, una) { \
+  bitset::siz_t const _lst = a.buckets() - 1; \
+  auto _acc = out; \
+  \
+  _Pragma("omp parallel for default(shared) schedule(static) reduction(+: _acc)") \
+  for (bitset::siz_t i = 0; i < _lst; ++i) { \
+    bitset::bck_t const _bck = EVAL_2(a, b, op, una, i); \
+    WPOP_BLOCK(_bck, w, i, bitset::bits); \
+  } \
+  \
+  bitset::bck_t const _bck = EVAL_2(a, b, op, una, _lst); \
+  WPOP_BLOCK(_bck, w, _lst, a.last_bits()); \
+  out = _acc; \
+}
+
 #define and3(a, b, c) ((a) & (b) & (c))
 #define maj(a, b, c) (((a) & (b)) | ((a) & (c)) | ((b) & (c)))
 #define ite(a, b, c) (((a) & (b)) | (~(a) & (c)))
+#define xor3(a, b, c) ((a) ^ (b) ^ (c))
+
+// Carry-save adder: h receives maj(a, b, c) and l receives xor3(a, b, c)
+#define csa(h, l, a, b, c) { \
+  bitset::bck_t const _u = (a) ^ (b); \
+  h = ((a) & (b)) | (_u & (c)); \
+  l = _u ^ (c); \
+}
 
 #define EVAL_3(a, b, c, op, una, i) una(op(a.bucket(i), b.bucket(i), c.bucket(i)))
 
@@ -45,10 +173,32 @@
   bitset::siz_t const _lst = a.buckets() - 1; \
   bitset::siz_t _pop = 0; \
   \
-  _Pragma("omp parallel for simd default(shared) schedule(static) reduction(+: _pop)") \
-  for (bitset::siz_t i = 0; i < _lst; ++i) { \
-    bitset::bck_t _bck = EVAL_3(a, b, c, op, una, i); \
-    OP_BLOCK(out, i); \
+  if (bitset::streaming(out, _lst)) { \
+    bitset::siz_t const _pairs = _lst & ~bitset::siz_t{ 1 }; \
+    \
+    _Pragma("omp parallel default(shared) reduction(+: _pop)") \
+    { \
+      _Pragma("omp for schedule(static) nowait") \
+      for (bitset::siz_t i = 0; i < _pairs; i += 2) { \
+        STREAM_PREFETCH(a, i); \
+        STREAM_PREFETCH(b, i); \
+        STREAM_PREFETCH(c, i); \
+        OP_STREAM_BLOCK(out, i, EVAL_3(a, b, c, op, una, i), EVAL_3(a, b, c, op, una, i + 1)); \
+      } \
+      \
+      STREAM_FENCE(); \
+    } \
+    \
+    for (bitset::siz_t i = _pairs; i < _lst; ++i) { \
+      bitset::bck_t _bck = EVAL_3(a, b, c, op, una, i); \
+      OP_BLOCK(out, i); \
+    } \
+  } else { \
+    _Pragma("omp parallel for simd default(shared) schedule(static) reduction(+: _pop)") \
+    for (bitset::siz_t i = 0; i < _lst; ++i) { \
+      bitset::bck_t _bck = EVAL_3(a, b, c, op, una, i); \
+      OP_BLOCK(out, i); \
+    } \
   } \
   \
   bitset::bck_t _bck = EVAL_3(a, b, c, op, una, _lst) & a.last_mask(); \
@@ -67,3 +217,48 @@
   \
   out = _pop + util::popcount(EVAL_3(a, b, c, op, una, _lst) & a.last_mask()); \
 }
+
+#define WPOP_3(a, b, c, w, out, op, una) { \
+  bitset::siz_t const _lst = a.buckets() - 1; \
+  auto _acc = out; \
+  \
+  _Pragma("omp parallel for default(shared) schedule(static) reduction(+: _acc)") \
+  for (bitset::siz_t i = 0; i < _lst; ++i) { \
+    bitset::bck_t const _bck = EVAL_3(a, b, c, op, una, i); \
+    WPOP_BLOCK(_bck, w, i, bitset::bits); \
+  } \
+  \
+  bitset::bck_t const _bck = EVAL_3(a, b, c, op, una, _lst); \
+  WPOP_BLOCK(_bck, w, _lst, a.last_bits()); \
+  out = _acc; \
+}
+
+#define POPB_3(a, b, c, out, limit, op, una) { \
+  bitset::siz_t const _lst = a.buckets() - 1; \
+  bitset::siz_t const _lim = limit; \
+  bitset::siz_t _pop = 0; \
+  \
+  _Pragma("omp parallel for default(shared) schedule(dynamic)") \
+  for (bitset::siz_t _c = 0; _c < _lst; _c += bitset::bound_chunk) { \
+    bitset::siz_t _now; \
+    _Pragma("omp atomic read") \
+    _now = _pop; \
+    \
+    if (_now > _lim) { \
+      continue; \
+    } \
+    \
+    bitset::siz_t const _end = std::min(_c + bitset::bound_chunk, _lst); \
+    bitset::siz_t _cnt = 0; \
+    \
+    _Pragma("omp simd reduction(+: _cnt)") \
+    for (bitset::siz_t i = _c; i < _end; ++i) { \
+      _cnt += util::popcount(EVAL_3(a, b, c, op, una, i)); \
+    } \
+    \
+    _Pragma("omp atomic update") \
+    _pop += _cnt; \
+  } \
+  \
+  out = _pop + util::popcount(EVAL_3(a, b, c, op, una, _lst) & a.last_mask()); \
+}
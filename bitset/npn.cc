@@ -0,0 +1,310 @@
+#include <numeric>
+#include <stdexcept>
+#include "npn.hh"
+
+// Bucket type
+using bck_t = bitset_npn::bck_t;
+// Size type
+using siz_t = bitset_npn::siz_t;
+// Table words
+using wrd_v = std::vector<bck_t>;
+
+// Masks of the positions whose bit b is clear (lower) or set (upper)
+static constexpr bck_t const lower[] = {
+  make_pattern_v<bck_t, 0, true>, make_pattern_v<bck_t, 1, true>,
+  make_pattern_v<bck_t, 2, true>, make_pattern_v<bck_t, 3, true>,
+  make_pattern_v<bck_t, 4, true>, make_pattern_v<bck_t, 5, true>
+};
+
+static constexpr bck_t const upper[] = {
+  make_pattern_v<bck_t, 0, false>, make_pattern_v<bck_t, 1, false>,
+  make_pattern_v<bck_t, 2, false>, make_pattern_v<bck_t, 3, false>,
+  make_pattern_v<bck_t, 4, false>, make_pattern_v<bck_t, 5, false>
+};
+
+// Negates position bit b, swapping both cofactors
+static void flip_bit (wrd_v& w, siz_t b) {
+  constexpr siz_t shift = bitset::bits_shift;
+
+  if (b < shift) {
+    siz_t const s = siz_t{ 1 } << b;
+
+    for (bck_t& x : w) {
+      x = ((x & upper[b]) >> s) | ((x & lower[b]) << s);
+    }
+
+    return;
+  }
+
+  siz_t const step = siz_t{ 1 } << (b - shift);
+
+  for (siz_t j = 0; j < w.size(); ++j) {
+    if (!(j & step)) {
+      std::swap(w[j], w[j | step]);
+    }
+  }
+}
+
+// Swaps position bits b1 < b2
+static void swap_bits (wrd_v& w, siz_t b1, siz_t b2) {
+  constexpr siz_t shift = bitset::bits_shift;
+
+  // Both within a word, moving positions with b1 set and b2 clear
+  if (b2 < shift) {
+    siz_t const s = (siz_t{ 1 } << b2) - (siz_t{ 1 } << b1);
+    bck_t const m = upper[b1] & lower[b2];
+
+    for (bck_t& x : w) {
+      x = (x & ~(m | (m << s))) | ((x & m) << s) | ((x >> s) & m);
+    }
+
+  // b1 within a word and b2 across words
+  } else if (b1 < shift) {
+    siz_t const s = siz_t{ 1 } << b1;
+    siz_t const step = siz_t{ 1 } << (b2 - shift);
+
+    for (siz_t j = 0; j < w.size(); ++j) {
+      if (!(j & step)) {
+        bck_t const a = w[j], c = w[j | step];
+        w[j] = (a & lower[b1]) | ((c & lower[b1]) << s);
+        w[j | step] = (c & upper[b1]) | ((a & upper[b1]) >> s);
+      }
+    }
+
+  // Both across words
+  } else {
+    siz_t const step1 = siz_t{ 1 } << (b1 - shift);
+    siz_t const step2 = siz_t{ 1 } << (b2 - shift);
+
+    for (siz_t j = 0; j < w.size(); ++j) {
+      if ((j & step1) and !(j & step2)) {
+        std::swap(w[j], w[j ^ step1 ^ step2]);
+      }
+    }
+  }
+}
+
+// Tests if a table is smaller, comparing from the last word
+static bool smaller (wrd_v const& a, wrd_v const& b) {
+  return std::lexicographical_compare(a.rbegin(), a.rend(), b.rbegin(), b.rend());
+}
+
+// Projections of each of the inputs
+std::vector<bitset> const& bitset_npn::projections (siz_t inputs) {
+  std::vector<bitset>& proj = this->projections_[inputs];
+
+  if (proj.size() != inputs) {
+    proj.resize(inputs);
+    bitset::build_combinations(proj.data(), inputs);
+  }
+
+  return proj;
+}
+
+// Canonicalizes a table, without the cache
+bitset_npn::result bitset_npn::compute (bitset const& f) {
+  siz_t const size = f.size();
+  siz_t const n = util::ctz(size);
+  siz_t const half = size / 2;
+  siz_t const pop = f.popcount();
+
+  wrd_v base(f.buckets());
+
+  for (siz_t j = 0; j < base.size(); ++j) {
+    base[j] = f.bucket(j);
+  }
+
+  base.back() &= f.last_mask();
+
+  // Ones on the positive cofactor of each position bit
+  siz_t ones[max_inputs];
+  std::vector<bitset> const& proj = this->projections(n);
+
+  for (siz_t b = 0; b < n; ++b) {
+    ones[b] = bitset::AND_popcount(f, proj[n - 1 - b]);
+  }
+
+  wrd_v best;
+  siz_t best_where[max_inputs] = {};
+  siz_t best_phase = 0;
+  bool best_neg = false;
+  siz_t tries = 0;
+
+  // The output is negated to keep at most half ones, trying both on ties
+  for (bool const neg : { false, true }) {
+    if ((neg and pop < half) or (!neg and pop > half)) {
+      continue;
+    }
+
+    siz_t const total = neg ? size - pop : pop;
+    siz_t key[max_inputs];
+    siz_t forced = 0;
+    std::vector<siz_t> ties;
+
+    // Inputs are negated to keep more ones on the positive cofactor
+    for (siz_t b = 0; b < n; ++b) {
+      siz_t const pos = neg ? half - ones[b] : ones[b];
+      siz_t const zero = total - pos;
+
+      if (pos < zero) {
+        forced |= siz_t{ 1 } << b;
+      } else if (pos == zero) {
+        ties.emplace_back(b);
+      }
+
+      key[b] = std::max(pos, zero);
+    }
+
+    // Bits sorted by decreasing key, from the highest position bit
+    siz_t order[max_inputs];
+    std::iota(order, order + n, 0);
+    std::stable_sort(order, order + n, [ &key ] (siz_t a, siz_t b) {
+      return key[a] > key[b];
+    });
+
+    // Groups of equal keys, whose members can take each other's position
+    std::vector<std::pair<siz_t, siz_t>> groups;
+
+    for (siz_t k = 0; k < n; ) {
+      siz_t e = k + 1;
+
+      while (e < n and key[order[e]] == key[order[k]]) {
+        ++e;
+      }
+
+      if (e - k > 1) {
+        groups.emplace_back(k, e);
+      }
+
+      k = e;
+    }
+
+    wrd_v negated = base;
+
+    if (neg) {
+      for (bck_t& x : negated) {
+        x = ~x;
+      }
+
+      negated.back() &= f.last_mask();
+    }
+
+    for (siz_t combo = 0; combo < (siz_t{ 1 } << ties.size()); ++combo) {
+      wrd_v phased = negated;
+      siz_t phase = forced;
+
+      for (siz_t t = 0; t < ties.size(); ++t) {
+        phase |= ((combo >> t) & 1) << ties[t];
+      }
+
+      for (siz_t b = 0; b < n; ++b) {
+        if ((phase >> b) & 1) {
+          flip_bit(phased, b);
+        }
+      }
+
+      siz_t perm[max_inputs];
+      std::copy(order, order + n, perm);
+
+      // Each permutation of the members of every group
+      for (bool more = true; more; ) {
+        wrd_v w = phased;
+        siz_t where[max_inputs];
+        std::iota(where, where + n, 0);
+
+        for (siz_t k = 0; k < n; ++k) {
+          siz_t const p = n - 1 - k;
+          siz_t const q = std::find(where, where + n, perm[k]) - where;
+
+          if (q != p) {
+            swap_bits(w, std::min(p, q), std::max(p, q));
+            std::swap(where[p], where[q]);
+          }
+        }
+
+        if (best.empty() or smaller(w, best)) {
+          best = std::move(w);
+          std::copy(where, where + n, best_where);
+          best_phase = phase;
+          best_neg = neg;
+        }
+
+        if (++tries >= this->budget()) {
+          break;
+        }
+
+        // Next permutation, as an odometer over the groups
+        more = false;
+
+        for (auto const& [ first, last ] : groups) {
+          if (std::next_permutation(perm + first, perm + last)) {
+            more = true;
+            break;
+          }
+        }
+      }
+
+      if (tries >= this->budget()) {
+        break;
+      }
+    }
+
+    if (tries >= this->budget()) {
+      break;
+    }
+  }
+
+  // Converts position bits to inputs
+  result res{ bitset{ size }, {}, 0, best_neg };
+
+  for (siz_t j = 0; j < best.size(); ++j) {
+    res.table.set_bucket(j, best[j]);
+  }
+
+  for (siz_t i = 0; i < n; ++i) {
+    siz_t const from = n - 1 - best_where[n - 1 - i];
+    res.perm[i] = from;
+    res.phase |= uint32_t((best_phase >> (n - 1 - from)) & 1) << from;
+  }
+
+  return res;
+}
+
+// Canonical form of a truth table
+bitset_npn::result bitset_npn::canonical (bitset const& f) {
+  if (!util::is_pow2(f.size()) or f.size() > (siz_t{ 1 } << max_inputs)) {
+    throw std::invalid_argument("NPN needs a truth table of 2^n bits, up to 16 inputs.");
+  }
+
+  auto const it = this->index_.find(f);
+
+  if (it != this->index_.end()) {
+    ++this->hits_;
+    this->recent_.splice(this->recent_.begin(), this->recent_, it->second);
+    return it->second->second;
+  }
+
+  ++this->misses_;
+  result res = this->compute(f);
+
+  if (this->capacity() == 0) {
+    return res;
+  }
+
+  // Evicts the least recently used result
+  if (this->size() >= this->capacity()) {
+    this->index_.erase(this->recent_.back().first);
+    this->recent_.pop_back();
+  }
+
+  this->recent_.emplace_front(f.copy(), res);
+  this->index_.emplace(this->recent_.front().first, this->recent_.begin());
+
+  return res;
+}
+
+// Drops the cached results
+void bitset_npn::clear (void) {
+  this->recent_.clear();
+  this->index_.clear();
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "base.hh"
+
+// NPN canonicalization of truth tables, with a cache of recent results
+// Input i of a table follows bitset::build_combinations, so it is bit
+// (inputs - 1 - i) of the position
+class bitset_npn {
+ public:
+  // Bucket type
+  using bck_t = bitset::bck_t;
+  // Size type
+  using siz_t = bitset::siz_t;
+
+  // Maximum number of inputs of the canonicalized tables
+  constexpr static siz_t const max_inputs = 16;
+
+  // Canonical form and the transform that leads to it:
+  // table(x) = negated ^ f(y), where input perm[i] of y is input i of x,
+  // negated when bit perm[i] of phase is set
+  struct result {
+    bitset table;
+    std::array<siz_t, max_inputs> perm;
+    uint32_t phase;
+    bool negated;
+  };
+
+ private:
+  using lru_t = std::list<std::pair<bitset, result>>;
+
+  // Maximum number of cached results
+  siz_t capacity_;
+  // Maximum number of candidate transforms tested per table
+  siz_t budget_;
+  // Cached results, most recent first
+  lru_t recent_;
+  // Cached results by table
+  std::unordered_map<bitset, lru_t::iterator> index_;
+  // Cache statistics
+  siz_t hits_ = 0, misses_ = 0;
+  // Projections of each input, by number of inputs
+  std::vector<bitset> projections_[max_inputs + 1];
+
+  // Projections of each of <inputs> inputs
+  std::vector<bitset> const& projections (siz_t inputs);
+
+  // Canonicalizes a table, without the cache
+  result compute (bitset const& f);
+
+ public:
+  // Constructor
+  explicit bitset_npn (siz_t capacity = 4096, siz_t budget = 4096)
+  : capacity_{ capacity }, budget_{ budget } {}
+
+  // Canonical form of a truth table of up to max_inputs inputs
+  // (std::invalid_argument for other sizes)
+  // When the budget ends before every tie is resolved, the form is only
+  // semi-canonical (equivalent tables may get different forms)
+  result canonical (bitset const& f);
+
+  // Drops the cached results
+  void clear (void);
+
+  // Getters
+  siz_t capacity (void) const { return this->capacity_; }
+  siz_t budget (void) const { return this->budget_; }
+  siz_t size (void) const { return this->recent_.size(); }
+  siz_t hits (void) const { return this->hits_; }
+  siz_t misses (void) const { return this->misses_; }
+};
@@ -3,10 +3,14 @@
 #include "evolution/base.hh"
 #include "evolution/macros.hh"
 #include "evolution/generators.hh"
+#include "evolution/cache.hh"
+#include "evolution/bitset_generators.hh"
 #include "evolution/one_lambda.hh"
 #include "evolution/clonalg.hh"
 #include "evolution/genetic.hh"
+#include "evolution/steady_state.hh"
 #include "evolution/nsga.hh"
 #include "evolution/nsais.hh"
+#include "evolution/nsga_steady.hh"
 
 #include "evolution/islands.hh"
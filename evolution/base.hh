@@ -6,8 +6,10 @@
 #include <functional>
 #include "../util_constexpr.hh"
 #include "../iterator.hh"
+#include "../random.hh"
 #include "macros.hh"
 #include "generators.hh"
+#include "cache.hh"
 
 namespace __EVO_NAMESPACE {
 
@@ -17,11 +19,15 @@ namespace __EVO_NAMESPACE {
     __EVO_USING_TYPES(base);
     __EVO_USING_FUNCTIONS;
 
+    using cache_t = fitness_cache<chr_t, fit_t>;
+
+    // Index of the best of <t_size> individuals drawn without replacement
+    template <typename RND>
     static siz_t tournament (
-      evo_t& evo, siz_t size, siz_t t_size, index_comparator const& cmp
+      siz_t size, siz_t t_size, index_comparator const& cmp, RND& rnd
     ) {
       using dist_t = std::uniform_int_distribution<siz_t>;
-      using dist_p = dist_t::param_type;
+      using dist_p = typename dist_t::param_type;
 
       dist_t dist;
       siz_t *idx = new siz_t[size];
@@ -29,7 +35,7 @@ namespace __EVO_NAMESPACE {
       std::iota(idx, idx + size, 0);
 
       for (siz_t i = 0; i < t_size; ++i) {
-        std::swap(idx[i], idx[dist(evo.random(), dist_p(i, size - 1))]);
+        std::swap(idx[i], idx[dist(rnd, dist_p(i, size - 1))]);
       }
 
       siz_t const choice = *std::min_element(idx, idx + t_size, cmp);
@@ -38,12 +44,18 @@ namespace __EVO_NAMESPACE {
       return choice;
     }
 
-    static siz_t roulette (
-      evo_t& evo, siz_t size, index_comparator const& cmp
+    static siz_t tournament (
+      evo_t& evo, siz_t size, siz_t t_size, index_comparator const& cmp
     ) {
+      return evo_t::tournament(size, t_size, cmp, evo.random());
+    }
+
+    // Index chosen with probability decreasing linearly with its rank
+    template <typename RND>
+    static siz_t roulette (siz_t size, index_comparator const& cmp, RND& rnd) {
       std::uniform_int_distribution<siz_t> dist(0, (size * (size - 1)) / 2);
       siz_t choice = size;
-      siz_t accum = dist(evo.random());
+      siz_t accum = dist(rnd);
       siz_t *idx = new siz_t[size];
 
       std::iota(idx, idx + size, 0);
@@ -64,13 +76,28 @@ namespace __EVO_NAMESPACE {
       return choice;
     }
 
+    static siz_t roulette (
+      evo_t& evo, siz_t size, index_comparator const& cmp
+    ) {
+      return evo_t::roulette(size, cmp, evo.random());
+    }
+
    private:
     rnd_t rnd_;
+    sed_t seed_ = 0;
+    siz_t generation_ = 0;
     siz_t dimensions_ = 0, max_size_ = 0, size_ = 0;
+    bool parallel_ = false;
 
     chr_t* chr_ = nullptr;
     fit_t* fit_ = nullptr;
 
+    // Stream of the generator call running on each thread
+    static inline thread_local util::random::philox stream_;
+
+    // Chromosomes dropped by the last selection, while generating
+    chr_v spare_;
+
     siz_t* best_ = nullptr;
     bool* best_set_ = nullptr;
 
@@ -80,6 +107,7 @@ namespace __EVO_NAMESPACE {
     creator create_ = nullptr;
     generator generate_ = nullptr;
     evaluator evaluate_ = nullptr;
+    std::shared_ptr<cache_t> cache_;
 
     step_event before_step_ = noop<step_event>;
     step_event after_step_ = noop<step_event>;
@@ -121,6 +149,9 @@ namespace __EVO_NAMESPACE {
       this->dimensions_ = evo.dimensions_;
       this->max_size_ = evo.max_size_;
       this->size_ = evo.size_;
+      this->parallel_ = evo.parallel_;
+      this->seed_ = evo.seed_;
+      this->generation_ = evo.generation_;
     }
 
     evo_t& copy_from (const base& evo, bool) {
@@ -145,6 +176,7 @@ namespace __EVO_NAMESPACE {
       this->create_ = evo.create_;
       this->generate_ = evo.generate_;
       this->evaluate_ = evo.evaluate_;
+      this->cache_ = evo.cache_;
 
       return *this;
     }
@@ -166,6 +198,7 @@ namespace __EVO_NAMESPACE {
       this->create_ = std::move(evo.create_);
       this->generate_ = std::move(evo.generate_);
       this->evaluate_ = std::move(evo.evaluate_);
+      this->cache_ = std::move(evo.cache_);
 
       evo.release(false);
       return *this;
@@ -198,27 +231,62 @@ namespace __EVO_NAMESPACE {
       std::fill(this->best_set_, this->best_set_ + this->dimensions(), false);
     }
 
+    // Evaluates a slice, in parallel when enabled (creation stays serial,
+    // and generation draws from per-call streams, so runs are reproducible
+    // regardless of the threads)
+    void evaluate (chr_t* chr, fit_t* fit, siz_t size) {
+      IF_OMP(parallel for schedule(dynamic) if(this->parallel() and size > 1))
+      for (siz_t i = 0; i < size; ++i) {
+        fit[i] = this->evaluate(chr[i]);
+      }
+    }
+
     virtual siz_t initialize (chr_t* chr, fit_t* fit, siz_t space) {
       for (siz_t i = 0; i < space; ++i) {
         chr[i] = this->create();
-        fit[i] = this->evaluate(chr[i]);
       }
 
+      this->evaluate(chr, fit, space);
       return space;
     }
 
+    // Fills <space> slots with children, generated by calls with their own
+    // streams: after the first call, which gives the number of children per
+    // call, the calls needed for the remaining slots run as a batch (in
+    // parallel when enabled) and their children are taken in call order, so
+    // the results do not depend on the threads
     virtual siz_t evolve (chr_t* chr, fit_t* fit, siz_t space) {
+      // The slots being filled hold the chromosomes dropped by the last
+      // selection, which generators can take through recycle()
+      this->spare_.assign(
+        std::make_move_iterator(chr), std::make_move_iterator(chr + space)
+      );
+
+      std::vector<chr_v> batch;
+      siz_t calls = 0, made = 0;
+
       for (siz_t i = 0; i < space; ) {
-        for (chr_t& child : this->generate()) {
-          chr[i] = std::move(child);
-          fit[i] = this->evaluate(chr[i]);
+        siz_t const per = calls ? std::max<siz_t>(made / calls, 1) : space;
+        batch.assign((space - i + per - 1) / per, chr_v{});
+
+        IF_OMP(parallel for schedule(dynamic) if(this->parallel() and batch.size() > 1))
+        for (siz_t b = 0; b < batch.size(); ++b) {
+          batch[b] = this->generate(calls + b);
+        }
+
+        calls += batch.size();
 
-          if (++i >= space) {
-            break;
+        for (chr_v& children : batch) {
+          made += children.size();
+
+          for (siz_t j = 0; j < children.size() and i < space; ++j, ++i) {
+            chr[i] = std::move(children[j]);
           }
         }
       }
 
+      this->spare_.clear();
+      this->evaluate(chr, fit, space);
       return space;
     }
 
@@ -241,10 +309,17 @@ namespace __EVO_NAMESPACE {
       return this->select(this->chr_, this->fit_, old, all);
     }
 
+    // Starts a generation of a single generator call, as asynchronous runs
+    // do for each batch of children they issue
+    chr_v generate_next (void) {
+      this->generation_ += 1;
+      return this->generate(0);
+    }
+
    public:
 
     base (siz_t dimensions, siz_t max_size, sed_t seed)
-    : rnd_{ seed }, dimensions_{ dimensions }, max_size_{ max_size } {
+    : rnd_{ seed }, seed_{ seed }, dimensions_{ dimensions }, max_size_{ max_size } {
       this->evo_t::alloc(false);
     }
 
@@ -261,6 +336,9 @@ namespace __EVO_NAMESPACE {
 
     virtual evo_t* copy (void) const = 0;
 
+    // Comparator and subtractor of an objective, which must be safe to call
+    // concurrently in parallel mode (generators select parents, and NSGA
+    // sorts and measures crowding, with several threads)
     void set_comparator (comparator const& cmp, siz_t dim = 0) {
       this->compare_[dim] = cmp;
     }
@@ -273,6 +351,16 @@ namespace __EVO_NAMESPACE {
     void set_evaluator (evaluator const& evl) { this->evaluate_ = evl; }
     void set_generator (generator const& gen) { this->generate_ = gen; }
 
+    // Generates and evaluates new individuals in parallel, which requires a
+    // generator and an evaluator that are safe to call concurrently (see
+    // also set_comparator), and generators that draw from stream() rather
+    // than random() for the results not to depend on the threads
+    void set_parallel (bool parallel) { this->parallel_ = parallel; }
+
+    // Memoizes the evaluations, possibly sharing the cache with other
+    // populations (the evaluator must not change the chromosome)
+    void set_cache (std::shared_ptr<cache_t> const& cache) { this->cache_ = cache; }
+
     void set_comparator (simple_comparator const& cmp, siz_t dim = 0) {
       this->set_comparator([ cmp ] (evo_t&, fit_t const& f1, fit_t const& f2) {
         return cmp(f1, f2);
@@ -290,7 +378,7 @@ namespace __EVO_NAMESPACE {
     }
 
     void set_evaluator (simple_evaluator const& evl) {
-      this->set_evaluator([ evl ] (evo_t&, chr_t const& chr) {
+      this->set_evaluator([ evl ] (evo_t&, chr_t& chr) {
         return evl(chr);
       });
     }
@@ -325,8 +413,39 @@ namespace __EVO_NAMESPACE {
     }
 
     chr_t create (void) { return this->create_(*this); }
-    chr_v generate (void) { return this->generate_(*this); }
-    fit_t evaluate (chr_t& chr) { return this->evaluate_(*this, chr); }
+
+    // Runs the generator as the call <call> of the current generation, with
+    // stream() set to the stream of that call
+    chr_v generate (siz_t call) {
+      stream_ = this->stream(call);
+      return this->generate_(*this);
+    }
+
+    chr_v generate (void) { return this->generate(0); }
+
+    // Takes a chromosome dropped by the last selection, or a default one
+    // outside of a step, so that generators can reuse its storage
+    chr_t recycle (void) {
+      chr_t chr;
+
+      IF_OMP(critical(evo_recycle))
+      if (!this->spare_.empty()) {
+        chr = std::move(this->spare_.back());
+        this->spare_.pop_back();
+      }
+
+      return chr;
+    }
+
+    fit_t evaluate (chr_t& chr) {
+      if (!this->cache_) {
+        return this->evaluate_(*this, chr);
+      }
+
+      return this->cache_->get(chr, [ this ] (chr_t& c) {
+        return this->evaluate_(*this, c);
+      });
+    }
 
     void populate (siz_t size) {
       this->on_before_start();
@@ -334,6 +453,7 @@ namespace __EVO_NAMESPACE {
       siz_t const old = this->size();
       siz_t const pop = std::min(size, this->max_size());
 
+      this->generation_ = 0;
       this->size_ = this->initialize(this->chr_, this->fit_, pop);
 
       if (old > this->size()) {
@@ -391,6 +511,7 @@ namespace __EVO_NAMESPACE {
       siz_t const old = this->size();
       siz_t const all = this->max_size();
 
+      this->generation_ += 1;
       this->size_ = this->select(old, this->evolve(old, all));
       this->reset_best();
 
@@ -493,12 +614,8 @@ namespace __EVO_NAMESPACE {
     }
 
     void set (siz_t pos, chr_v&& chrs) {
-      fit_v fits;
-      fits.reserve(chrs.size());
-
-      for (chr_t& chr : chrs) {
-        fits.emplace_back(this->evaluate(chr));
-      }
+      fit_v fits(chrs.size());
+      this->evaluate(chrs.data(), fits.data(), chrs.size());
 
       this->set(pos, std::move(chrs), std::move(fits));
     }
@@ -512,6 +629,18 @@ namespace __EVO_NAMESPACE {
     inline rnd_t& random (void) { return this->rnd_; }
     inline rnd_t const& random (void) const { return this->rnd_; }
 
+    // Independent stream of the current generation, keyed by the seed and
+    // addressed by an individual and a purpose (e.g. selection, mutation)
+    // Unlike random(), its numbers do not depend on the order of the draws,
+    // so it can be used from any thread with reproducible results
+    inline util::random::philox stream (siz_t individual, siz_t purpose = 0) const {
+      return util::random::philox{ this->seed_, this->generation_, individual, purpose };
+    }
+
+    // Stream of the generator call running on this thread, from which
+    // generators, mutators and selectors draw (see evolve)
+    static inline util::random::philox& stream (void) { return stream_; }
+
     inline chr_t const& chr_at (siz_t pos) const { return this->chr_[pos]; }
     inline fit_t const& fit_at (siz_t pos) const { return this->fit_[pos]; }
 
@@ -526,6 +655,9 @@ namespace __EVO_NAMESPACE {
     inline siz_t size (void) const { return this->size_; }
     inline siz_t max_size (void) const { return this->max_size_; }
     inline siz_t dimensions (void) const { return this->dimensions_; }
+    inline bool parallel (void) const { return this->parallel_; }
+    inline siz_t generation (void) const { return this->generation_; }
+    inline std::shared_ptr<cache_t> const& cache (void) const { return this->cache_; }
 
     expand_all_const_iterators((void), const_chr_iterator, this->chr_, this->chr_ + this->size(), chr, false);
     expand_all_const_iterators((void), const_fit_iterator, this->fit_, this->fit_ + this->size(), fit, false);
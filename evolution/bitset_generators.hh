@@ -0,0 +1,280 @@
+#pragma once
+
+#include <functional>
+#include <random>
+#include <vector>
+#include <unordered_set>
+#include "../bitset.hh"
+#include "macros.hh"
+
+namespace __EVO_NAMESPACE {
+
+  template <typename EVO>
+  class bitset_generators {
+   public:
+    __EVO_COPY_TYPES(bitset_generators, typename EVO);
+    __EVO_USING_FUNCTIONS;
+
+    static_assert(
+      std::is_same_v<chr_t, bitset>,
+      "bitset_generators requires bitset chromosomes."
+    );
+
+    // Picks the index of a parent from the population
+    using selector = std::function<siz_t(evo_t&)>;
+
+    // Selector of parents by tournament, drawing from the stream of the
+    // generator call
+    static selector tournament (siz_t t_size, siz_t dim = 0) {
+      return [ t_size, dim ] (evo_t& evo) {
+        return evo_t::tournament(
+          evo.size(), t_size, evo.make_index_comparator(dim), evo.stream()
+        );
+      };
+    }
+
+    // Flips each bit with probability <rate>, jumping over geometric gaps
+    template <typename RND>
+    static siz_t flip_uniform (bitset& bs, double rate, RND& rnd) {
+      if (rate <= 0.0) {
+        return 0;
+      }
+
+      // Every bit flips, and the gaps need a rate below 1
+      if (rate >= 1.0) {
+        bs.flip();
+        return bs.size();
+      }
+
+      std::geometric_distribution<siz_t> gap(rate);
+      siz_t flips = 0;
+
+      for (siz_t pos = gap(rnd); pos < bs.size(); pos += gap(rnd) + 1) {
+        bs.flip(pos);
+        ++flips;
+      }
+
+      return flips;
+    }
+
+    // Flips exactly <count> distinct bits, chosen with Floyd's algorithm
+    template <typename RND>
+    static siz_t flip_exact (bitset& bs, siz_t count, RND& rnd) {
+      using dist_t = std::uniform_int_distribution<siz_t>;
+      using dist_p = typename dist_t::param_type;
+
+      // Up to this amount, chosen positions are searched linearly
+      constexpr siz_t linear = 64;
+
+      siz_t const size = bs.size();
+      count = std::min(count, size);
+
+      dist_t dist;
+      std::vector<siz_t> chosen;
+      std::unordered_set<siz_t> chosen_set;
+
+      if (count <= linear) {
+        chosen.reserve(count);
+      } else {
+        chosen_set.reserve(count);
+      }
+
+      for (siz_t j = size - count; j < size; ++j) {
+        siz_t pos = dist(rnd, dist_p(0, j));
+
+        if (count <= linear) {
+          if (std::find(chosen.begin(), chosen.end(), pos) != chosen.end()) {
+            pos = j;
+          }
+
+          chosen.emplace_back(pos);
+
+        } else if (!chosen_set.emplace(pos).second) {
+          pos = j;
+          chosen_set.emplace(pos);
+        }
+
+        bs.flip(pos);
+      }
+
+      return count;
+    }
+
+    // Flips <count> blocks of <length> contiguous bits at random positions
+    template <typename RND>
+    static siz_t flip_blocks (bitset& bs, siz_t count, siz_t length, RND& rnd) {
+      length = std::min(length, bs.size());
+      std::uniform_int_distribution<siz_t> dist(0, bs.size() - length);
+
+      for (siz_t i = 0; i < count; ++i) {
+        siz_t const start = dist(rnd);
+        bs.flip(start, start + length);
+      }
+
+      return count * length;
+    }
+
+    // Sorted <count> distinct crossover points on (0, size)
+    template <typename RND>
+    static std::vector<siz_t> cross_points (siz_t size, siz_t count, RND& rnd) {
+      using dist_t = std::uniform_int_distribution<siz_t>;
+      using dist_p = typename dist_t::param_type;
+
+      std::vector<siz_t> points;
+      dist_t dist;
+
+      count = std::min(count, size ? size - 1 : 0);
+      points.reserve(count);
+
+      // Floyd's algorithm over [1, size)
+      for (siz_t j = size - count; j < size; ++j) {
+        siz_t pos = dist(rnd, dist_p(1, j));
+
+        if (std::find(points.begin(), points.end(), pos) != points.end()) {
+          pos = j;
+        }
+
+        points.emplace_back(pos);
+      }
+
+      std::sort(points.begin(), points.end());
+      return points;
+    }
+
+    // Mask selecting exactly half of the bits where <a> and <b> differ
+    template <typename RND>
+    static bitset half_mask (bitset const& a, bitset const& b, RND& rnd) {
+      using dist_t = std::uniform_int_distribution<siz_t>;
+      using dist_p = typename dist_t::param_type;
+
+      bitset diff, mask{ a.size() };
+      bitset::XOR(a, b, diff);
+
+      siz_t const last = diff.buckets() - 1;
+      siz_t left = diff.popcount();
+      siz_t needed = left / 2;
+      dist_t dist;
+
+      // Selection sampling, visiting only the differing bits
+      for (siz_t i = 0; needed and i <= last; ++i) {
+        bitset::bck_t bck = diff.bucket(i);
+
+        if (i == last) {
+          bck &= diff.last_mask();
+        }
+
+        for (; needed and bck; bck &= bck - 1, --left) {
+          if (dist(rnd, dist_p(0, left - 1)) < needed) {
+            mask.set(i * bitset::bits + util::ctz(bck));
+            --needed;
+          }
+        }
+      }
+
+      return mask;
+    }
+
+    // Crossovers write both children over the storage of the chromosomes
+    // dropped by the last selection, taken with evo_t::recycle()
+    // Generators and mutators draw from evo_t::stream(), so they give the
+    // same children on any thread
+
+    // Crossover swapping each bit with probability 0.5
+    static generator uniform_cross (selector const& select) {
+      return [ select ] (evo_t& evo) -> chr_v {
+        chr_t const& a = evo.chr_at(select(evo));
+        chr_t const& b = evo.chr_at(select(evo));
+        chr_v result;
+
+        result.emplace_back(evo.recycle());
+        result.emplace_back(evo.recycle());
+
+        bitset mask{ a.size(), false, false };
+        std::uniform_int_distribution<uint64_t> seed;
+        mask.fill_random(0.5, seed(evo.stream()));
+
+        bitset::crossover(a, b, mask, result[0], result[1]);
+        return result;
+      };
+    }
+
+    // Crossover swapping the parents at <count> random points
+    static generator points_cross (siz_t count, selector const& select) {
+      return [ count, select ] (evo_t& evo) -> chr_v {
+        chr_t const& a = evo.chr_at(select(evo));
+        chr_t const& b = evo.chr_at(select(evo));
+        chr_v result;
+
+        result.emplace_back(evo.recycle());
+        result.emplace_back(evo.recycle());
+
+        std::vector<siz_t> const points = bitset_generators::cross_points(
+          a.size(), count, evo.stream()
+        );
+
+        bitset::crossover(a, b, points.data(), points.size(), result[0], result[1]);
+        return result;
+      };
+    }
+
+    // Crossover swapping exactly half of the differing bits (HUX)
+    static generator half_uniform_cross (selector const& select) {
+      return [ select ] (evo_t& evo) -> chr_v {
+        chr_t const& a = evo.chr_at(select(evo));
+        chr_t const& b = evo.chr_at(select(evo));
+        chr_v result;
+
+        result.emplace_back(evo.recycle());
+        result.emplace_back(evo.recycle());
+
+        bitset const mask = bitset_generators::half_mask(a, b, evo.stream());
+
+        bitset::crossover(a, b, mask, result[0], result[1]);
+        return result;
+      };
+    }
+
+    // Mutator that flips each bit with probability <rate>
+    static mutator uniform (double rate) {
+      return [ rate ] (evo_t& evo, chr_t const& chr) -> chr_v {
+        chr_v result;
+        result.emplace_back(chr.copy());
+        bitset_generators::flip_uniform(result.back(), rate, evo.stream());
+        return result;
+      };
+    }
+
+    // Mutator that flips each bit with probability 1 / size
+    static mutator uniform (void) {
+      return [] (evo_t& evo, chr_t const& chr) -> chr_v {
+        chr_v result;
+        result.emplace_back(chr.copy());
+        bitset_generators::flip_uniform(
+          result.back(), 1.0 / static_cast<double>(chr.size()), evo.stream()
+        );
+        return result;
+      };
+    }
+
+    // Mutator that flips exactly <count> bits
+    static mutator exact (siz_t count) {
+      return [ count ] (evo_t& evo, chr_t const& chr) -> chr_v {
+        chr_v result;
+        result.emplace_back(chr.copy());
+        bitset_generators::flip_exact(result.back(), count, evo.stream());
+        return result;
+      };
+    }
+
+    // Mutator that flips <count> blocks of <length> bits
+    static mutator blocks (siz_t count, siz_t length) {
+      return [ count, length ] (evo_t& evo, chr_t const& chr) -> chr_v {
+        chr_v result;
+        result.emplace_back(chr.copy());
+        bitset_generators::flip_blocks(result.back(), count, length, evo.stream());
+        return result;
+      };
+    }
+  };
+
+};
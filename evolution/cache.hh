@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "macros.hh"
+#include "../random.hh"
+
+namespace __EVO_NAMESPACE {
+
+  // Bounded memoization of fitness values, keyed by chromosome hash and
+  // equality, which can be shared by several populations
+  // Entries are split in shards with their own lock, so concurrent
+  // evaluations rarely contend, and each shard evicts with a clock policy
+  template <typename CHR, typename FIT>
+  class fitness_cache {
+   public:
+    using chr_t = CHR;
+    using fit_t = FIT;
+    using siz_t = uintmax_t;
+
+    using hasher = std::function<std::size_t(chr_t const&)>;
+    using equality = std::function<bool(chr_t const&, chr_t const&)>;
+
+   private:
+    struct entry {
+      chr_t chr;
+      fit_t fit;
+      std::size_t hash;
+      // Second chance of the clock
+      bool referenced;
+    };
+
+    struct shard {
+      std::mutex mutex;
+      std::vector<entry> entries;
+      std::unordered_multimap<std::size_t, siz_t> index;
+      // Next entry inspected for eviction
+      siz_t hand = 0;
+      // Share of the capacity, so the shards add up to it exactly
+      siz_t capacity = 0;
+    };
+
+    siz_t capacity_, shards_;
+    std::unique_ptr<shard[]> shard_;
+
+    hasher hash_;
+    equality equal_;
+
+    std::atomic<siz_t> hits_{ 0 }, misses_{ 0 };
+
+    shard& shard_of (std::size_t hash) {
+      uint64_t state = hash;
+      return this->shard_[util::random::splitmix64(state) % this->shards_];
+    }
+
+    // Finds an entry of a shard, whose lock is held
+    entry* find (shard& sh, chr_t const& chr, std::size_t hash) {
+      auto const [ first, last ] = sh.index.equal_range(hash);
+
+      for (auto it = first; it != last; ++it) {
+        entry& e = sh.entries[it->second];
+
+        if (this->equal_(e.chr, chr)) {
+          return &e;
+        }
+      }
+
+      return nullptr;
+    }
+
+   public:
+    // Constructor, for up to <capacity> entries split in <shards> shards
+    // A zero capacity stores nothing, so every lookup misses
+    explicit fitness_cache (
+      siz_t capacity, siz_t shards = 16,
+      hasher const& hash = std::hash<chr_t>{},
+      equality const& equal = std::equal_to<chr_t>{}
+    ) : capacity_{ capacity }, shards_{ std::max<siz_t>(shards, 1) },
+        shard_{ new shard[std::max<siz_t>(shards, 1)] },
+        hash_{ hash }, equal_{ equal } {
+      for (siz_t i = 0; i < this->shards_; ++i) {
+        this->shard_[i].capacity = this->capacity_ / this->shards_
+          + (i < this->capacity_ % this->shards_);
+      }
+    }
+
+    fitness_cache (fitness_cache const&) = delete;
+    fitness_cache& operator = (fitness_cache const&) = delete;
+
+    // Looks up the fitness of a chromosome
+    bool find (chr_t const& chr, fit_t& fit) {
+      std::size_t const hash = this->hash_(chr);
+      shard& sh = this->shard_of(hash);
+      std::lock_guard<std::mutex> lock{ sh.mutex };
+
+      if (entry* e = this->find(sh, chr, hash)) {
+        e->referenced = true;
+        fit = e->fit;
+        this->hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+
+      this->misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    // Stores the fitness of a chromosome, evicting an entry if full
+    void insert (chr_t const& chr, fit_t const& fit) {
+      std::size_t const hash = this->hash_(chr);
+      shard& sh = this->shard_of(hash);
+      std::lock_guard<std::mutex> lock{ sh.mutex };
+
+      if (entry* e = this->find(sh, chr, hash)) {
+        e->fit = fit;
+        e->referenced = true;
+        return;
+      }
+
+      if (sh.entries.size() < sh.capacity) {
+        sh.index.emplace(hash, sh.entries.size());
+        sh.entries.push_back(entry{ chr, fit, hash, false });
+        return;
+      }
+
+      // Shard without any room, as with a capacity below the shard count
+      if (sh.entries.empty()) {
+        return;
+      }
+
+      // Clears referenced entries until finding one to replace
+      while (sh.entries[sh.hand].referenced) {
+        sh.entries[sh.hand].referenced = false;
+        sh.hand = (sh.hand + 1) % sh.entries.size();
+      }
+
+      siz_t const victim = sh.hand;
+      entry& e = sh.entries[victim];
+      auto const [ first, last ] = sh.index.equal_range(e.hash);
+
+      for (auto it = first; it != last; ++it) {
+        if (it->second == victim) {
+          sh.index.erase(it);
+          break;
+        }
+      }
+
+      e = entry{ chr, fit, hash, false };
+      sh.index.emplace(hash, victim);
+      sh.hand = (victim + 1) % sh.entries.size();
+    }
+
+    // Fitness of a chromosome, computed and stored on a miss
+    // The computation runs without the lock, so concurrent misses on the
+    // same chromosome may both compute it
+    template <typename F>
+    fit_t get (chr_t& chr, F&& compute) {
+      fit_t fit;
+
+      if (!this->find(chr, fit)) {
+        fit = compute(chr);
+        this->insert(chr, fit);
+      }
+
+      return fit;
+    }
+
+    // Drops every entry and resets the counters
+    void clear (void) {
+      for (siz_t i = 0; i < this->shards_; ++i) {
+        std::lock_guard<std::mutex> lock{ this->shard_[i].mutex };
+        this->shard_[i].entries.clear();
+        this->shard_[i].index.clear();
+        this->shard_[i].hand = 0;
+      }
+
+      this->hits_ = 0;
+      this->misses_ = 0;
+    }
+
+    siz_t size (void) {
+      siz_t total = 0;
+
+      for (siz_t i = 0; i < this->shards_; ++i) {
+        std::lock_guard<std::mutex> lock{ this->shard_[i].mutex };
+        total += this->shard_[i].entries.size();
+      }
+
+      return total;
+    }
+
+    siz_t capacity (void) const { return this->capacity_; }
+    siz_t shards (void) const { return this->shards_; }
+    siz_t hits (void) const { return this->hits_; }
+    siz_t misses (void) const { return this->misses_; }
+  };
+
+};
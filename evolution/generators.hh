@@ -13,13 +13,12 @@ namespace __EVO_NAMESPACE {
     static generator always_cross (
       generator const& cross, mutator const& mutate, double m_prob
     ) {
-      std::uniform_real_distribution<double> dist;
-
-      return [ cross, mutate, m_prob, &dist ] (evo_t& evo) -> chr_v {
+      return [ cross, mutate, m_prob ] (evo_t& evo) -> chr_v {
+        std::uniform_real_distribution<double> dist;
         chr_v off;
 
         for (chr_t& child : cross(evo)) {
-          if (dist(evo.random()) > m_prob) {
+          if (dist(evo.stream()) > m_prob) {
             off.emplace_back(std::move(child));
             continue;
           }
@@ -35,10 +34,10 @@ namespace __EVO_NAMESPACE {
     static generator cross_or_mutate (
       generator const& cross, generator const& mutate, double m_prob
     ) {
-      std::uniform_real_distribution<double> dist;
+      return [ cross, mutate, m_prob ] (evo_t& evo) -> chr_v {
+        std::uniform_real_distribution<double> dist;
 
-      return [ cross, mutate, m_prob, &dist ] (evo_t& evo) -> chr_v {
-        if (dist(evo.random()) > m_prob) {
+        if (dist(evo.stream()) > m_prob) {
           return cross(evo);
         }
 
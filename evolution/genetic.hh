@@ -25,9 +25,10 @@ namespace __EVO_NAMESPACE {
     siz_t select (chr_t* chr, fit_t* fit, siz_t old, siz_t all) override {
       this->partition_best(chr, fit, old, this->elitism());
 
+      // Swapped, so that the dropped chromosomes can be recycled
       for (siz_t i = this->elitism(), j = old; i < this->popsize(); ++i, ++j) {
-        chr[i] = std::move(chr[j]);
-        fit[i] = std::move(fit[j]);
+        std::swap(chr[i], chr[j]);
+        std::swap(fit[i], fit[j]);
       }
 
       return this->popsize();
@@ -49,20 +49,21 @@ namespace __EVO_NAMESPACE {
       }
 
       for (siz_t i = 0; i < this->size(); ++i) {
-        if (ot.world_[i] != nullptr) {
-          this->world_[i] = ot.world_[i]->copy();
-        }
+        delete this->world_[i];
+        this->world_[i] = ot.world_[i] ? ot.world_[i]->copy() : nullptr;
       }
 
       this->rnd_ = ot.rnd_;
+      return *this;
     }
 
-    islands& move_from (islands&& ot) {
-      this->free();
+    islands& move_from (islands& ot, bool) {
+      this->free(false);
       this->copy_meta(ot, false);
       this->world_ = ot.world_;
       this->rnd_ = std::move(ot.rnd_);
       ot.release(false);
+      return *this;
     }
 
    public:
@@ -70,14 +71,16 @@ namespace __EVO_NAMESPACE {
     : rnd_{ seed }, size_{ size } { this->alloc(false); }
 
     islands (islands const& ot) { this->copy_from(ot, false); }
-    islands (islands&& ot) { this->move_from(std::move(ot), false); }
+    islands (islands&& ot) { this->move_from(ot, false); }
+
+    ~islands (void) { this->free(false); }
 
     islands& operator = (islands const& ot) {
       return this->copy_from(ot, false);
     }
 
     islands& operator = (islands&& ot) {
-      return this->move_from(std::move(ot), false);
+      return this->move_from(ot, false);
     }
 
     inline rnd_t& random (void) { return this->rnd_; }
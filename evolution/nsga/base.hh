@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include "../../string.hh"
+#include "../../bitset.hh"
 #include "../base.hh"
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 namespace __EVO_NAMESPACE {
 
   __EVO_TMPL_HEAD
@@ -17,12 +23,49 @@ namespace __EVO_NAMESPACE {
     using const_fro_iterator = siz_t const*;
     using const_dis_iterator = dis_t const*;
 
+    // Maps a fitness to the value of an objective, lower being better
+    using projector = std::function<dis_t(fit_t const&)>;
+
+    // Fronts at least this large are ordered by radix sort
+    constexpr static siz_t const radix_threshold = 256;
+
+    // In parallel mode, with objective columns, more than two objectives and
+    // enough threads, populations within these sizes are sorted from a
+    // dominance matrix built in parallel (a single thread builds it about as
+    // fast as ENS-BS sorts with eight objectives, and ten times slower with
+    // three), which is kept between generations and takes up to 32 MiB
+    constexpr static siz_t const matrix_threshold = 1024;
+    constexpr static siz_t const matrix_limit = siz_t{ 1 } << 14;
+    // Rows and columns of the tiles of the dominance matrix
+    constexpr static siz_t const matrix_tile = 256;
+
    protected:
     siz_t popsize_;
     siz_t children_;
     siz_t fronts_;
-    siz_t *fro_;
-    dis_t *dis_;
+    siz_t *fro_ = nullptr;
+    dis_t *dis_ = nullptr;
+
+    // Scratch of the non-dominated sorting: individuals in lexicographic
+    // order, previous member of the front of each individual and last
+    // member of each front
+    siz_t *ord_ = nullptr;
+    siz_t *prv_ = nullptr;
+    siz_t *lst_ = nullptr;
+
+    // Objective columns (structure of arrays), used when every objective
+    // has a projector, with the scratch of the crowding distance (a region
+    // per objective, and the contribution of each objective)
+    projector *prj_ = nullptr;
+    dis_t *col_ = nullptr;
+    dis_t *con_ = nullptr;
+    dis_t *key_ = nullptr;
+    siz_t *srt_ = nullptr;
+    uint64_t *rdx_ = nullptr;
+    bool columns_ = false;
+
+    // Dominance matrix, allocated on first use and reused while large enough
+    bitset_array mat_;
 
     void alloc (bool parent) override {
       if (parent) {
@@ -31,6 +74,17 @@ namespace __EVO_NAMESPACE {
 
       this->fro_ = new siz_t[this->max_size()];
       this->dis_ = new dis_t[this->max_size()];
+
+      this->ord_ = new siz_t[this->max_size()];
+      this->prv_ = new siz_t[this->max_size()];
+      this->lst_ = new siz_t[this->max_size()];
+
+      this->prj_ = new projector[this->dimensions()]();
+      this->col_ = new dis_t[this->dimensions() * this->max_size()];
+      this->con_ = new dis_t[this->dimensions() * this->max_size()];
+      this->key_ = new dis_t[2 * this->dimensions() * this->max_size()];
+      this->srt_ = new siz_t[2 * this->dimensions() * this->max_size()];
+      this->rdx_ = new uint64_t[2 * this->dimensions() * this->max_size()];
     }
 
     void release (bool parent) override {
@@ -40,6 +94,17 @@ namespace __EVO_NAMESPACE {
 
       this->fro_ = nullptr;
       this->dis_ = nullptr;
+
+      this->ord_ = nullptr;
+      this->prv_ = nullptr;
+      this->lst_ = nullptr;
+
+      this->prj_ = nullptr;
+      this->col_ = nullptr;
+      this->con_ = nullptr;
+      this->key_ = nullptr;
+      this->srt_ = nullptr;
+      this->rdx_ = nullptr;
     }
 
     void free (bool parent) override {
@@ -49,6 +114,17 @@ namespace __EVO_NAMESPACE {
 
       delete[] this->fro_;
       delete[] this->dis_;
+
+      delete[] this->ord_;
+      delete[] this->prv_;
+      delete[] this->lst_;
+
+      delete[] this->prj_;
+      delete[] this->col_;
+      delete[] this->con_;
+      delete[] this->key_;
+      delete[] this->srt_;
+      delete[] this->rdx_;
       this->release(false);
     }
 
@@ -63,7 +139,8 @@ namespace __EVO_NAMESPACE {
     }
 
     nsga& copy_from (nsga const& ot, bool parent) {
-      bool const dif = this->max_size() != ot.max_size();
+      bool const dif = this->max_size() != ot.max_size()
+        or this->dimensions() != ot.dimensions();
 
       if (parent) {
         this->evo_t::copy_from(ot, true);
@@ -73,10 +150,13 @@ namespace __EVO_NAMESPACE {
         this->free(false);
         this->copy_meta(ot, false);
         this->alloc(false);
+      } else {
+        this->copy_meta(ot, false);
       }
 
       std::copy(ot.fro_, ot.fro_ + ot.max_size(), this->fro_);
       std::copy(ot.dis_, ot.dis_ + ot.max_size(), this->dis_);
+      std::copy(ot.prj_, ot.prj_ + ot.dimensions(), this->prj_);
 
       return *this;
     }
@@ -91,6 +171,18 @@ namespace __EVO_NAMESPACE {
 
       this->fro_ = std::move(ot.fro_);
       this->dis_ = std::move(ot.dis_);
+
+      this->ord_ = std::move(ot.ord_);
+      this->prv_ = std::move(ot.prv_);
+      this->lst_ = std::move(ot.lst_);
+
+      this->prj_ = std::move(ot.prj_);
+      this->col_ = std::move(ot.col_);
+      this->con_ = std::move(ot.con_);
+      this->key_ = std::move(ot.key_);
+      this->srt_ = std::move(ot.srt_);
+      this->rdx_ = std::move(ot.rdx_);
+      this->mat_ = std::move(ot.mat_);
       ot.release(true);
 
       return *this;
@@ -123,81 +215,442 @@ namespace __EVO_NAMESPACE {
       return a_dom ^ b_dom;
     }
 
-    siz_t nd_sorting (
-      fit_t const* fit, siz_t* ranks, siz_t* ranked, siz_t* ends,
-      siz_t size, siz_t fill
-    ) {
-      if (fill == 0) {
-        return 0;
+    // Column of an objective
+    dis_t* column (siz_t dim) const { return this->col_ + dim * this->max_size(); }
+
+    // Fills the objective columns, if every objective has a projector
+    bool load_columns (fit_t const* fit, siz_t size) {
+      this->columns_ = std::all_of(
+        this->prj_, this->prj_ + this->dimensions(),
+        [] (projector const& prj) { return bool(prj); }
+      );
+
+      for (siz_t d = 0; this->columns_ and d < this->dimensions(); ++d) {
+        dis_t* const col = this->column(d);
+
+        for (siz_t i = 0; i < size; ++i) {
+          // Adding zero turns -0.0 into 0.0, so both get the same key
+          col[i] = this->prj_[d](fit[i]) + 0.0;
+        }
+      }
+
+      return this->columns_;
+    }
+
+    // Dominance of two individuals, by position
+    bool dominates (fit_t const* fit, siz_t a, siz_t b, bool& a_d, bool& b_d) {
+      if (!this->columns_) {
+        return this->dominates(fit[a], fit[b], a_d, b_d);
       }
 
-      siz_v* dominated = new siz_v[size]();
-      siz_t* count = new siz_t[size]();
-      siz_t* queue = ranked;
-      siz_t* start = ranked;
+      bool a_dom = false;
+      bool b_dom = false;
+
+      for (siz_t i = 0; i < this->dimensions() and !(a_dom and b_dom); ++i) {
+        dis_t const* const col = this->column(i);
+        a_dom |= col[a] < col[b];
+        b_dom |= col[b] < col[a];
+      }
+
+      a_d = a_dom;
+      b_d = b_dom;
+
+      return a_dom ^ b_dom;
+    }
+
+    // Lexicographic order of the objectives, by index on ties
+    bool lex_compare (fit_t const* fit, siz_t a, siz_t b) {
+      for (siz_t i = 0; i < this->dimensions(); ++i) {
+        if (this->columns_) {
+          dis_t const* const col = this->column(i);
+
+          if (col[a] != col[b]) {
+            return col[a] < col[b];
+          }
+        } else if (this->compare(fit[a], fit[b], i)) {
+          return true;
+        } else if (this->compare(fit[b], fit[a], i)) {
+          return false;
+        }
+      }
+
+      return a < b;
+    }
+
+    // Stable sort of positions by their value in a column
+    // Large inputs use an LSD radix sort over order-preserving integer keys,
+    // with the scratch at <off> (see cd_column)
+    void argsort (dis_t const* col, siz_t* idx, siz_t size, siz_t off) {
+      if (size < radix_threshold) {
+        for (siz_t i = 1; i < size; ++i) {
+          siz_t const pos = idx[i];
+          siz_t j = i;
+
+          for (; j > 0 and col[pos] < col[idx[j - 1]]; --j) {
+            idx[j] = idx[j - 1];
+          }
+
+          idx[j] = pos;
+        }
+
+        return;
+      }
+
+      constexpr siz_t digit = 11;
+      constexpr siz_t buckets = siz_t{ 1 } << digit;
+
+      uint64_t* key = this->rdx_ + off;
+      uint64_t* key_tmp = this->rdx_ + off + this->max_size();
+      siz_t* out = idx;
+      siz_t* out_tmp = this->srt_ + off + this->max_size();
 
       for (siz_t i = 0; i < size; ++i) {
-        bool i_d, j_d;
-
-        for (siz_t j = i + 1; j < size; ++j) {
-          if (this->dominates(fit[i], fit[j], i_d, j_d)) {
-            if (i_d) {
-              dominated[i].emplace_back(j);
-              count[j]++;
-            } else {
-              dominated[j].emplace_back(i);
-              count[i]++;
+        uint64_t bits;
+        std::memcpy(&bits, col + idx[i], sizeof(bits));
+        key[i] = (bits >> 63) ? ~bits : bits | (uint64_t{ 1 } << 63);
+      }
+
+      for (siz_t shift = 0; shift < 64; shift += digit) {
+        siz_t count[buckets] = {};
+
+        for (siz_t i = 0; i < size; ++i) {
+          count[(key[i] >> shift) & (buckets - 1)] += 1;
+        }
+
+        // Skips digits shared by every key
+        if (count[(key[0] >> shift) & (buckets - 1)] == size) {
+          continue;
+        }
+
+        for (siz_t b = 0, sum = 0; b < buckets; ++b) {
+          siz_t const c = count[b];
+          count[b] = sum;
+          sum += c;
+        }
+
+        for (siz_t i = 0; i < size; ++i) {
+          siz_t const to = count[(key[i] >> shift) & (buckets - 1)]++;
+          key_tmp[to] = key[i];
+          out_tmp[to] = out[i];
+        }
+
+        std::swap(key, key_tmp);
+        std::swap(out, out_tmp);
+      }
+
+      if (out != idx) {
+        std::copy(out, out + size, idx);
+      }
+    }
+
+    // Tests if a member of a front dominates an individual that comes
+    // after all of them in lexicographic order
+    bool front_dominates (fit_t const* fit, siz_t front, siz_t pos, siz_t none) {
+      bool i_d, j_d;
+
+      // With up to two objectives the last member has the best value of the
+      // last objective in its front, so it dominates if any member does
+      if (this->dimensions() <= 2) {
+        return this->dominates(fit, this->lst_[front], pos, i_d, j_d) and i_d;
+      }
+
+      for (siz_t m = this->lst_[front]; m != none; m = this->prv_[m]) {
+        if (this->dominates(fit, m, pos, i_d, j_d) and i_d) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    // Efficient non-dominated sort with binary search (ENS-BS): individuals
+    // are visited in lexicographic order, so none is dominated by a later
+    // one, and each goes to the first front with no member dominating it
+    // Fronts are found by binary search, as being dominated by a front
+    // implies being dominated by all fronts before it, which makes the sort
+    // O(N log N) for two objectives, and the scratch is preallocated
+    siz_t nd_ens (fit_t const* fit, siz_t* ranks, siz_t size) {
+      siz_t* const ord = this->ord_;
+      siz_t const none = size;
+      siz_t total = 0;
+
+      std::iota(ord, ord + size, 0);
+      std::sort(ord, ord + size, [ this, fit ] (siz_t a, siz_t b) {
+        return this->lex_compare(fit, a, b);
+      });
+
+      for (siz_t k = 0; k < size; ++k) {
+        siz_t const pos = ord[k];
+        siz_t lo = 0, hi = total;
+
+        while (lo < hi) {
+          siz_t const mid = lo + (hi - lo) / 2;
+
+          if (this->front_dominates(fit, mid, pos, none)) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+
+        if (lo == total) {
+          this->lst_[total++] = none;
+        }
+
+        ranks[pos] = lo;
+        this->prv_[pos] = this->lst_[lo];
+        this->lst_[lo] = pos;
+      }
+
+      return total;
+    }
+
+    // Non-dominated sort from a dominance matrix, whose rows (the
+    // individuals each one dominates) are filled from the objective columns
+    // in parallel over tiles, each row by a single thread, and then peeled
+    // front by front
+    siz_t nd_matrix (siz_t* ranks, siz_t size) {
+      if (this->mat_.count() < size) {
+        this->mat_ = bitset_array{ size, size };
+      }
+
+      // Rows may be wider than the population, but only their first
+      // buckets are written and read
+      bitset_array& dom = this->mat_;
+      siz_t const buckets = bitset::count_buckets(size);
+      siz_t* const count = this->prv_;
+      siz_t* const queue = this->ord_;
+
+      std::fill(count, count + size, 0);
+
+      IF_OMP(parallel for schedule(dynamic) if(this->parallel()))
+      for (siz_t ib = 0; ib < size; ib += matrix_tile) {
+        siz_t const ie = std::min(ib + matrix_tile, size);
+
+        for (siz_t jb = 0; jb < size; jb += matrix_tile) {
+          siz_t const je = std::min(jb + matrix_tile, size);
+
+          for (siz_t i = ib; i < ie; ++i) {
+            bitset row = dom[i];
+            // Flags as wide as the objectives, which keeps the loop vectorized
+            uint64_t better[matrix_tile] = {}, worse[matrix_tile] = {};
+
+            // Compares a row of the tile one objective at a time
+            for (siz_t d = 0; d < this->dimensions(); ++d) {
+              dis_t const* const col = this->column(d);
+              dis_t const ci = col[i];
+
+              IF_OMP(simd)
+              for (siz_t j = jb; j < je; ++j) {
+                better[j - jb] |= ci < col[j];
+                worse[j - jb] |= col[j] < ci;
+              }
+            }
+
+            // Tiles start on a bucket, so each bucket is written once
+            for (siz_t w = 0; w * bitset::bits < je - jb; ++w) {
+              bitset::bck_t dominated = 0, dominating = 0;
+              siz_t const first = w * bitset::bits;
+              siz_t const last = std::min(first + bitset::bits, je - jb);
+
+              for (siz_t k = first; k < last; ++k) {
+                bitset::bck_t const bit = bitset::bck_t{ 1 } << (k - first);
+                dominated |= (better[k] & ~worse[k]) ? bit : 0;
+                dominating |= (worse[k] & ~better[k]) ? bit : 0;
+              }
+
+              row.set_bucket(jb / bitset::bits + w, dominated);
+              count[i] += util::popcount(dominating);
             }
           }
         }
+      }
+
+      siz_t head = 0, tail = 0, total = 0;
 
+      for (siz_t i = 0; i < size; ++i) {
         if (count[i] == 0) {
           ranks[i] = 0;
-          *(ranked++) = i;
+          queue[tail++] = i;
         }
       }
 
-      siz_t fronts = 0;
-      siz_t found = 0;
-      bool stop = false;
+      while (head < tail) {
+        siz_t const pos = queue[head++];
+        bitset::bck_t const* const row = dom.data(pos);
 
-      while (queue != ranked and !stop) {
-        siz_t const pos = *(queue++);
+        total = ranks[pos] + 1;
 
-        for (siz_t const dom : dominated[pos]) {
-          if (--count[dom] != 0) {
-            continue;
+        for (siz_t w = 0; w < buckets; ++w) {
+          for (bitset::bck_t bck = row[w]; bck != 0; bck &= bck - 1) {
+            siz_t const j = w * bitset::bits + util::ctz(bck);
+
+            if (--count[j] == 0) {
+              ranks[j] = ranks[pos] + 1;
+              queue[tail++] = j;
+            }
           }
+        }
+      }
+
+      return total;
+    }
 
-          ranks[dom] = ranks[pos] + 1;
+    // Tests if a population is sorted from the dominance matrix
+    bool use_matrix (siz_t size) const {
+#ifdef _OPENMP
+      siz_t const threads = omp_get_max_threads();
+#else
+      siz_t const threads = 1;
+#endif
+
+      return this->parallel() and this->columns_ and this->dimensions() > 2
+        and threads * (this->dimensions() - 1) >= 16
+        and size >= matrix_threshold and size <= matrix_limit;
+    }
 
-          if (ranks[dom] != fronts) {
-            found += ranked - start;
-            ends[fronts++] = found;
-            start = ranked;
-            stop = found >= fill;
-          }
+    // Ranks the individuals and groups them by front, returning the number
+    // of fronts needed to reach <fill> individuals
+    // Members of each front are given in increasing index order, so the
+    // result does not depend on the method or the number of threads
+    siz_t nd_sorting (
+      fit_t const* fit, siz_t* ranks, siz_t* ranked, siz_t* ends,
+      siz_t size, siz_t fill
+    ) {
+      if (fill == 0) {
+        return 0;
+      }
 
-          *(ranked++) = dom;
+      siz_t const total = this->use_matrix(size)
+        ? this->nd_matrix(ranks, size)
+        : this->nd_ens(fit, ranks, size);
 
-          if (stop) {
-            break;
-          }
+      // Groups the individuals by front, with a counting sort
+      std::fill(ends, ends + total, 0);
+
+      for (siz_t i = 0; i < size; ++i) {
+        ends[ranks[i]] += 1;
+      }
+
+      siz_t fronts = 0;
+
+      for (siz_t f = 0, found = 0; f < total; ++f) {
+        found += ends[f];
+        ends[f] = found;
+
+        if (fronts == 0 and found >= fill) {
+          fronts = f + 1;
+        }
+      }
+
+      for (siz_t i = size; i-- > 0; ) {
+        ranked[--ends[ranks[i]]] = i;
+      }
+
+      for (siz_t f = 0; f < total; ++f) {
+        ends[f] = (f + 1 < total) ? ends[f + 1] : size;
+      }
+
+      return fronts ? fronts : total;
+    }
+
+    // Contribution of an objective to the crowding distance of a front that
+    // starts at <start> in the ranked list, infinite on the extremes
+    // Each pair of front and objective has its own scratch region, so they
+    // can be computed concurrently
+    void cd_column (siz_t const* order, siz_t size, siz_t start, siz_t dim) {
+      siz_t const last = size - 1;
+      siz_t const off = 2 * dim * this->max_size() + start;
+      siz_t* const idx = this->srt_ + off;
+      dis_t* const key = this->key_ + off;
+      dis_t* const gap = this->key_ + off + this->max_size();
+      dis_t const* const col = this->column(dim);
+      dis_t* const con = this->con_ + dim * this->max_size();
+
+      std::copy(order, order + size, idx);
+      this->argsort(col, idx, size, off);
+
+      for (siz_t j = 0; j < size; ++j) {
+        key[j] = col[idx[j]];
+      }
+
+      dis_t const delta = 1.0 / (key[last] - key[0]);
+
+      IF_OMP(simd)
+      for (siz_t j = 1; j < last; ++j) {
+        gap[j] = delta * (key[j + 1] - key[j - 1]);
+      }
+
+      con[idx[0]] = std::numeric_limits<dis_t>::infinity();
+      con[idx[last]] = std::numeric_limits<dis_t>::infinity();
+
+      for (siz_t j = 1; j < last; ++j) {
+        con[idx[j]] = gap[j];
+      }
+    }
+
+    // Adds the contributions of the objectives, in order
+    void cd_sum (dis_t* distance, siz_t const* order, siz_t size) {
+      for (siz_t i = 0; i < size; ++i) {
+        siz_t const pos = order[i];
+        dis_t sum = 0.0;
+
+        for (siz_t d = 0; d < this->dimensions(); ++d) {
+          dis_t const con = this->con_[d * this->max_size() + pos];
+          sum = (con == std::numeric_limits<dis_t>::infinity()) ? con : sum + con;
         }
+
+        distance[pos] = sum;
+      }
+    }
+
+    // Crowding distance from the objective columns, with contiguous keys
+    void cd_columns (dis_t* distance, siz_t const* order, siz_t size) {
+      for (siz_t d = 0; d < this->dimensions(); ++d) {
+        this->cd_column(order, size, 0, d);
       }
 
-      if (!stop) {
-        found += ranked - start;
-        ends[fronts++] = found;
+      this->cd_sum(distance, order, size);
+    }
+
+    // Crowding distance of the first <fronts> fronts, in parallel mode over
+    // the fronts and, with objective columns, over the objectives
+    // (without columns, the subtractors are called concurrently)
+    void cd_fronts (fit_t const* fit, siz_t* ranked, siz_t const* ends, siz_t fronts) {
+      if (!this->columns_) {
+        IF_OMP(parallel for schedule(dynamic) if(this->parallel()))
+        for (siz_t f = 0; f < fronts; ++f) {
+          siz_t const start = (f == 0) ? 0 : ends[f - 1];
+          this->cd_sorting(fit, this->dis_, ranked + start, ends[f] - start);
+        }
+
+        return;
       }
 
-      delete[] count;
-      delete[] dominated;
+      siz_t const dims = this->dimensions();
+
+      IF_OMP(parallel if(this->parallel()))
+      {
+        IF_OMP(for schedule(dynamic))
+        for (siz_t t = 0; t < fronts * dims; ++t) {
+          siz_t const f = t / dims;
+          siz_t const start = (f == 0) ? 0 : ends[f - 1];
+          this->cd_column(ranked + start, ends[f] - start, start, t % dims);
+        }
 
-      return fronts;
+        IF_OMP(for schedule(dynamic))
+        for (siz_t f = 0; f < fronts; ++f) {
+          siz_t const start = (f == 0) ? 0 : ends[f - 1];
+          this->cd_sum(this->dis_, ranked + start, ends[f] - start);
+        }
+      }
     }
 
     void cd_sorting (fit_t const* fit, dis_t* distance, siz_t* order, siz_t size) {
+      if (this->columns_) {
+        return this->cd_columns(distance, order, size);
+      }
+
       siz_t const last = size - 1;
       siz_t* idx = new siz_t[size];
 
@@ -241,14 +694,13 @@ namespace __EVO_NAMESPACE {
       siz_t* ranked = new siz_t[all];
       siz_t* ends = new siz_t[all];
 
+      this->load_columns(fit, all);
+
       siz_t const fronts = this->nd_sorting(fit, this->fro_, ranked, ends, all, this->popsize());
       siz_t const found = ends[fronts - 1];
 
       this->fronts_ = fronts;
-
-      for (siz_t i = 0, start = 0; i < fronts; start = ends[i], ++i) {
-        this->cd_sorting(fit, this->dis_, ranked + start, ends[i] - start);
-      }
+      this->cd_fronts(fit, ranked, ends, fronts);
 
       if (found > this->popsize()) {
         siz_t const conti = (fronts < 2) ? 0 : ends[fronts - 2];
@@ -263,6 +715,8 @@ namespace __EVO_NAMESPACE {
         ranked, ranked + all, this->popsize(), chr, fit, this->dis_, this->fro_
       );
 
+      this->columns_ = false;
+
       delete[] ends;
       delete[] ranked;
       return this->popsize();
@@ -282,6 +736,7 @@ namespace __EVO_NAMESPACE {
     : nsga{ popsize, popsize, dimensions, seed } {}
 
     nsga (nsga const& ot) : __EVO_BASE{ ot } {
+      this->alloc(false);
       this->copy_from(ot, false);
     }
 
@@ -289,15 +744,48 @@ namespace __EVO_NAMESPACE {
       this->move_from(ot, false);
     }
 
+    // The base destructor only frees the base arrays
+    ~nsga (void) { this->free(false); }
+
     nsga& operator = (nsga const& ot) { return this->copy_from(ot, true); }
     nsga& operator = (nsga&& ot) { return this->move_from(ot, true); }
 
     evo_t* copy (void) const override { return new nsga(*this); }
 
+    // Sets the projector of an objective, enabling the objective columns
+    // once every objective has one (it must agree with the comparator and
+    // subtractor of the objective)
+    void set_projector (projector const& prj, siz_t dim = 0) {
+      this->prj_[dim] = prj;
+    }
+
+    // Sets comparator, subtractor and projector of an objective to minimize
+    // or maximize, for fitness types indexed by objective
+    template <typename F = fit_t>
+    auto set_minimize (siz_t dim) -> decltype(dis_t(std::declval<F const&>()[0]), void()) {
+      this->set_comparator([ dim ] (fit_t const& a, fit_t const& b) { return a[dim] < b[dim]; }, dim);
+      this->set_subtractor([ dim ] (fit_t const& a, fit_t const& b) { return dis_t(a[dim]) - dis_t(b[dim]); }, dim);
+      this->set_projector([ dim ] (fit_t const& f) { return dis_t(f[dim]); }, dim);
+    }
+
+    template <typename F = fit_t>
+    auto set_maximize (siz_t dim) -> decltype(dis_t(std::declval<F const&>()[0]), void()) {
+      this->set_comparator([ dim ] (fit_t const& a, fit_t const& b) { return a[dim] > b[dim]; }, dim);
+      this->set_subtractor([ dim ] (fit_t const& a, fit_t const& b) { return dis_t(b[dim]) - dis_t(a[dim]); }, dim);
+      this->set_projector([ dim ] (fit_t const& f) { return -dis_t(f[dim]); }, dim);
+    }
+
     siz_t popsize (void) const { return this->popsize_; }
     siz_t children (void) const { return this->children_; }
     siz_t fronts (void) const { return this->fronts_; }
 
+    bool columns (void) const {
+      return std::all_of(
+        this->prj_, this->prj_ + this->dimensions(),
+        [] (projector const& prj) { return bool(prj); }
+      );
+    }
+
     siz_t front_at (siz_t pos) const { return this->fro_[pos]; }
     dis_t distance_at (siz_t pos) const { return this->dis_[pos]; }
 
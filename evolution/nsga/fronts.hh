@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "../macros.hh"
+
+namespace __EVO_NAMESPACE {
+
+  // Non-dominated fronts of a population, updated one individual at a time
+  // (ENLU-style insertion and deletion), so only the fronts an individual
+  // affects are visited
+  // Individuals are positions, and dominance is given by a callable
+  // dom(a, b) that tests if a dominates b
+  class front_index {
+   public:
+    using siz_t = uintmax_t;
+    using range = std::pair<siz_t, siz_t>;
+
+   private:
+    std::vector<std::vector<siz_t>> fronts_;
+    // Front of each position and its place within the front
+    std::vector<siz_t> rank_;
+    std::vector<siz_t> slot_;
+
+    void add (siz_t pos, siz_t front) {
+      if (pos >= this->rank_.size()) {
+        this->rank_.resize(pos + 1);
+        this->slot_.resize(pos + 1);
+      }
+
+      this->rank_[pos] = front;
+      this->slot_[pos] = this->fronts_[front].size();
+      this->fronts_[front].emplace_back(pos);
+    }
+
+    void take (siz_t pos) {
+      std::vector<siz_t>& front = this->fronts_[this->rank_[pos]];
+      siz_t const slot = this->slot_[pos];
+
+      front[slot] = front.back();
+      this->slot_[front[slot]] = slot;
+      front.pop_back();
+    }
+
+    template <typename DOM>
+    static bool dominated (std::vector<siz_t> const& by, siz_t pos, DOM const& dom) {
+      return std::any_of(by.begin(), by.end(), [ &dom, pos ] (siz_t m) {
+        return dom(m, pos);
+      });
+    }
+
+   public:
+    // Rebuilds the fronts from the ranks of <size> positions
+    void build (siz_t const* ranks, siz_t size) {
+      this->fronts_.clear();
+
+      for (siz_t i = 0; i < size; ++i) {
+        if (ranks[i] >= this->fronts_.size()) {
+          this->fronts_.resize(ranks[i] + 1);
+        }
+
+        this->add(i, ranks[i]);
+      }
+    }
+
+    void clear (void) {
+      this->fronts_.clear();
+      this->rank_.clear();
+      this->slot_.clear();
+    }
+
+    // First front with no member dominating a position, by binary search,
+    // as being dominated by a front implies being dominated by the previous
+    template <typename DOM>
+    siz_t find (siz_t pos, DOM const& dom) const {
+      siz_t lo = 0, hi = this->fronts_.size();
+
+      while (lo < hi) {
+        siz_t const mid = lo + (hi - lo) / 2;
+
+        if (front_index::dominated(this->fronts_[mid], pos, dom)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+
+      return lo;
+    }
+
+    // Inserts a position, returning the range of fronts that changed
+    // Members dominated by the newcomers move one front down, in cascade
+    template <typename DOM>
+    range insert (siz_t pos, DOM const& dom) {
+      siz_t const first = this->find(pos, dom);
+      siz_t k = first;
+      std::vector<siz_t> moving{ pos }, down;
+
+      for (; !moving.empty(); ++k) {
+        if (k == this->fronts_.size()) {
+          this->fronts_.emplace_back();
+        }
+
+        down.clear();
+
+        for (siz_t const q : this->fronts_[k]) {
+          if (front_index::dominated(moving, q, dom)) {
+            down.emplace_back(q);
+          }
+        }
+
+        for (siz_t const q : down) {
+          this->take(q);
+        }
+
+        for (siz_t const s : moving) {
+          this->add(s, k);
+        }
+
+        std::swap(moving, down);
+      }
+
+      return { first, k };
+    }
+
+    // Removes a position, returning the range of fronts that changed
+    // Members of the next front left without a dominator move one front up,
+    // in cascade
+    template <typename DOM>
+    range remove (siz_t pos, DOM const& dom) {
+      siz_t const first = this->rank_[pos];
+      siz_t k = first;
+      std::vector<siz_t> gone{ pos }, up;
+
+      this->take(pos);
+
+      for (; !gone.empty() and k + 1 < this->fronts_.size(); ++k) {
+        up.clear();
+
+        for (siz_t const c : this->fronts_[k + 1]) {
+          if (front_index::dominated(gone, c, dom)
+              and !front_index::dominated(this->fronts_[k], c, dom)) {
+            up.emplace_back(c);
+          }
+        }
+
+        for (siz_t const c : up) {
+          this->take(c);
+          this->add(c, k);
+        }
+
+        std::swap(gone, up);
+      }
+
+      while (!this->fronts_.empty() and this->fronts_.back().empty()) {
+        this->fronts_.pop_back();
+      }
+
+      return { first, std::min(k + 1, this->size()) };
+    }
+
+    // Moves the individual at a position to another, free, position
+    void rename (siz_t from, siz_t to) {
+      if (to >= this->rank_.size()) {
+        this->rank_.resize(to + 1);
+        this->slot_.resize(to + 1);
+      }
+
+      this->rank_[to] = this->rank_[from];
+      this->slot_[to] = this->slot_[from];
+      this->fronts_[this->rank_[to]][this->slot_[to]] = to;
+    }
+
+    siz_t size (void) const { return this->fronts_.size(); }
+    siz_t rank (siz_t pos) const { return this->rank_[pos]; }
+    std::vector<siz_t> const& front (siz_t k) const { return this->fronts_[k]; }
+  };
+
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <mutex>
+#include "base.hh"
+#include "nsga/base.hh"
+#include "nsga/fronts.hh"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace __EVO_NAMESPACE {
+
+  // Steady-state NSGA-II, (mu + 1): each step inserts one child into the
+  // fronts and removes the most crowded member of the last front
+  // The fronts are maintained incrementally, so a step only visits the
+  // fronts the child and the removed member affect, and only their crowding
+  // distances are recomputed
+  // Like steady_state, run() inserts children asynchronously, each one as
+  // soon as it is evaluated
+  __EVO_TMPL_HEAD
+  class nsga_steady : public __EVO_CLASS(nsga) {
+
+   public:
+    __EVO_USING_TYPES(nsga_steady);
+    __EVO_USING_FUNCTIONS;
+
+    using nsga_t = __EVO_CLASS(nsga);
+    using range = front_index::range;
+
+   protected:
+    front_index index_;
+    siz_t evaluations_ = 0, accepted_ = 0;
+
+    // Children evaluated by run(), waiting to be inserted
+    chr_v pending_chr_;
+    fit_v pending_fit_;
+
+    // Recomputes ranks and crowding distances of a range of fronts
+    // Members are taken by position, as in a full sort, so that ties in the
+    // objectives resolve the same way
+    void refresh (fit_t const* fit, range const& fronts) {
+      for (siz_t k = fronts.first; k < fronts.second; ++k) {
+        std::vector<siz_t> const& front = this->index_.front(k);
+
+        std::copy(front.begin(), front.end(), this->ord_);
+        std::sort(this->ord_, this->ord_ + front.size());
+
+        for (siz_t const pos : front) {
+          this->fro_[pos] = k;
+        }
+
+        this->cd_sorting(fit, this->dis_, this->ord_, front.size());
+      }
+    }
+
+    siz_t initialize (chr_t* chr, fit_t* fit, siz_t) override {
+      siz_t const size = this->popsize();
+      siz_t* ranked = new siz_t[size];
+      siz_t* ends = new siz_t[size];
+
+      this->evo_t::initialize(chr, fit, size);
+      this->load_columns(fit, size);
+
+      siz_t const fronts = this->nd_sorting(fit, this->fro_, ranked, ends, size, size);
+
+      this->index_.clear();
+      this->index_.build(this->fro_, size);
+      this->cd_fronts(fit, ranked, ends, fronts);
+
+      this->fronts_ = fronts;
+      this->columns_ = false;
+
+      delete[] ends;
+      delete[] ranked;
+      return size;
+    }
+
+    siz_t evolve (chr_t* chr, fit_t* fit, siz_t space) override {
+      if (this->pending_chr_.empty()) {
+        return this->nsga_t::evolve(chr, fit, space);
+      }
+
+      siz_t const size = std::min<siz_t>(space, this->pending_chr_.size());
+
+      std::move(this->pending_chr_.begin(), this->pending_chr_.begin() + size, chr);
+      std::move(this->pending_fit_.begin(), this->pending_fit_.begin() + size, fit);
+      this->pending_chr_.clear();
+      this->pending_fit_.clear();
+
+      return size;
+    }
+
+    siz_t select (chr_t* chr, fit_t* fit, siz_t old, siz_t all) override {
+      auto const dom = [ this, fit ] (siz_t a, siz_t b) {
+        bool a_d, b_d;
+        return this->dominates(fit, a, b, a_d, b_d) and a_d;
+      };
+
+      this->load_columns(fit, all);
+
+      for (siz_t child = old; child < all; ++child) {
+        range const added = this->index_.insert(child, dom);
+        siz_t const last = this->index_.size() - 1;
+
+        this->refresh(fit, added);
+
+        if (added.second <= last) {
+          this->refresh(fit, { last, last + 1 });
+        }
+
+        // The most crowded member of the last front leaves
+        std::vector<siz_t> const& worst = this->index_.front(last);
+        siz_t const out = *std::min_element(worst.begin(), worst.end(),
+          [ this ] (siz_t a, siz_t b) {
+            return this->crowding_compare(this->dis_[b], this->dis_[a])
+              or (this->dis_[a] == this->dis_[b] and a > b);
+          }
+        );
+
+        range const removed = this->index_.remove(out, dom);
+
+        // The child takes the place of the removed member, which changes the
+        // order of its front too
+        if (out != child) {
+          std::swap(chr[out], chr[child]);
+          std::swap(fit[out], fit[child]);
+
+          for (siz_t d = 0; d < this->dimensions(); ++d) {
+            std::swap(this->column(d)[out], this->column(d)[child]);
+          }
+
+          this->index_.rename(child, out);
+        }
+
+        this->refresh(fit, removed);
+
+        if (out != child) {
+          siz_t const k = this->index_.rank(out);
+
+          if (k < removed.first or k >= removed.second) {
+            this->refresh(fit, { k, k + 1 });
+          }
+
+          this->accepted_ += 1;
+        }
+
+        this->evaluations_ += 1;
+      }
+
+      this->fronts_ = this->index_.size();
+      this->columns_ = false;
+
+      return this->popsize();
+    }
+
+   public:
+    nsga_steady (siz_t popsize, siz_t dimensions, siz_t seed)
+    : __EVO_CLASS(nsga){ popsize, 1, dimensions, seed } {}
+
+    evo_t* copy (void) const override { return new nsga_steady(*this); }
+
+    // Evaluates <count> children asynchronously on <threads> workers
+    // (0 for the OpenMP default), as steady_state::run
+    // Generation and insertion are serialized, while evaluations run
+    // concurrently and finish in any order, so the evaluator must be safe to
+    // call concurrently and the results depend on the timing of the workers
+    void run (siz_t count, siz_t threads = 0) {
+      std::mutex mutex;
+      siz_t issued = 0;
+
+      IF_OMP(parallel num_threads(threads ? threads : omp_get_max_threads()))
+      for (;;) {
+        chr_v children;
+
+        {
+          std::lock_guard<std::mutex> lock{ mutex };
+
+          if (issued >= count) {
+            break;
+          }
+
+          children = this->generate_next();
+
+          if (children.empty()) {
+            break;
+          }
+
+          if (children.size() > count - issued) {
+            children.resize(count - issued);
+          }
+
+          issued += children.size();
+        }
+
+        for (chr_t& child : children) {
+          fit_t fit = this->evaluate(child);
+
+          // Inserted as a step of a single child, without generating it
+          std::lock_guard<std::mutex> lock{ mutex };
+          siz_t const old = this->popsize();
+
+          this->pending_chr_.emplace_back(std::move(child));
+          this->pending_fit_.emplace_back(std::move(fit));
+          this->evo_t::select(old, this->evo_t::evolve(old, old + 1));
+          this->reset_best();
+        }
+      }
+    }
+
+    // Children evaluated and inserted into the population
+    siz_t evaluations (void) const { return this->evaluations_; }
+    siz_t accepted (void) const { return this->accepted_; }
+  };
+
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <mutex>
+#include "base.hh"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace __EVO_NAMESPACE {
+
+  // Steady-state evolution: each child replaces a member of the population
+  // as soon as it is evaluated
+  // step() evaluates a batch of popsize children and inserts them in order,
+  // while run() keeps a pool of workers generating, evaluating and inserting
+  // children independently, so slow evaluations do not stall the others
+  // Replacement by fronts and crowding (NSGA) is done by nsga_steady, which
+  // has the same run()
+  __EVO_TMPL_HEAD
+  class steady_state : public __EVO_BASE {
+   public:
+    __EVO_USING_TYPES(steady_state);
+    __EVO_USING_FUNCTIONS;
+
+    // Member replaced by a child, if the child is not worse
+    enum class replacement { worst, tournament };
+
+   protected:
+    siz_t popsize_;
+    replacement replace_ = replacement::worst;
+    siz_t t_size_ = 2;
+    siz_t evaluations_ = 0, accepted_ = 0;
+
+    // Chooses the member to be replaced by a child, or popsize if none
+    siz_t victim (fit_t const* fit, fit_t const& child) {
+      siz_t loser;
+
+      if (this->replace_ == replacement::worst) {
+        loser = this->find_worst(fit, this->popsize());
+      } else {
+        index_comparator const cmp = this->make_index_comparator(fit);
+
+        loser = evo_t::tournament(*this, this->popsize(), this->t_size_,
+          [ &cmp ] (siz_t const& a, siz_t const& b) { return cmp(b, a); }
+        );
+      }
+
+      return this->compare(fit[loser], child) ? this->popsize() : loser;
+    }
+
+    siz_t initialize (chr_t* chr, fit_t* fit, siz_t) override {
+      return this->evo_t::initialize(chr, fit, this->popsize());
+    }
+
+    siz_t evolve (chr_t* chr, fit_t* fit, siz_t) override {
+      return this->evo_t::evolve(chr, fit, this->popsize());
+    }
+
+    siz_t select (chr_t* chr, fit_t* fit, siz_t old, siz_t all) override {
+      for (siz_t j = old; j < all; ++j) {
+        siz_t const v = this->victim(fit, fit[j]);
+        this->evaluations_ += 1;
+
+        if (v < this->popsize()) {
+          std::swap(chr[v], chr[j]);
+          std::swap(fit[v], fit[j]);
+          this->accepted_ += 1;
+        }
+      }
+
+      return this->popsize();
+    }
+
+   public:
+    steady_state (siz_t popsize, sed_t seed = 0)
+    : evo_t{ popsize + popsize, seed }, popsize_{ popsize } {}
+
+    evo_t* copy (void) const override { return new gen_t(*this); }
+
+    void set_replacement (replacement replace, siz_t t_size = 2) {
+      this->replace_ = replace;
+      this->t_size_ = std::max<siz_t>(std::min(t_size, this->popsize()), 1);
+    }
+
+    // Evaluates <count> children asynchronously on <threads> workers
+    // (0 for the OpenMP default)
+    // Generation and insertion are serialized, while evaluations run
+    // concurrently and finish in any order, so the evaluator must be safe to
+    // call concurrently and the results depend on the timing of the workers
+    void run (siz_t count, siz_t threads = 0) {
+      std::mutex mutex;
+      siz_t issued = 0;
+
+      IF_OMP(parallel num_threads(threads ? threads : omp_get_max_threads()))
+      for (;;) {
+        chr_v children;
+
+        {
+          std::lock_guard<std::mutex> lock{ mutex };
+
+          if (issued >= count) {
+            break;
+          }
+
+          children = this->generate_next();
+
+          if (children.empty()) {
+            break;
+          }
+
+          if (children.size() > count - issued) {
+            children.resize(count - issued);
+          }
+
+          issued += children.size();
+        }
+
+        for (chr_t& child : children) {
+          fit_t fit = this->evaluate(child);
+
+          std::lock_guard<std::mutex> lock{ mutex };
+          siz_t const v = this->victim(&this->fit_at(0), fit);
+          this->evaluations_ += 1;
+
+          if (v < this->popsize()) {
+            this->set(v, std::move(child), std::move(fit));
+            this->accepted_ += 1;
+          }
+        }
+      }
+    }
+
+    siz_t popsize (void) const { return this->popsize_; }
+    replacement replace (void) const { return this->replace_; }
+    siz_t t_size (void) const { return this->t_size_; }
+
+    // Children evaluated and inserted into the population
+    siz_t evaluations (void) const { return this->evaluations_; }
+    siz_t accepted (void) const { return this->accepted_; }
+  };
+
+};
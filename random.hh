@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace util::random {
+
+  // Rotates the bits of <value> to the left
+  constexpr uint64_t rotl (uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  // Advances a splitmix64 state, returning its next output
+  // Thanks to https://prng.di.unimi.it/splitmix64.c
+  constexpr uint64_t splitmix64 (uint64_t& state) {
+    uint64_t z = (state += UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+  }
+
+  // xoshiro256++ generator, usable as a standard random engine
+  // Thanks to https://prng.di.unimi.it/xoshiro256plusplus.c
+  class xoshiro256 {
+   public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min (void) { return 0; }
+    static constexpr result_type max (void) {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    // Advances a state given as separate words (keeps lanes vectorizable)
+    static constexpr uint64_t step (
+      uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3
+    ) {
+      uint64_t const result = rotl(s0 + s3, 23) + s0;
+      uint64_t const t = s1 << 17;
+
+      s2 ^= s0;
+      s3 ^= s1;
+      s1 ^= s2;
+      s0 ^= s3;
+      s2 ^= t;
+      s3 = rotl(s3, 45);
+
+      return result;
+    }
+
+   private:
+    uint64_t s_[4];
+
+   public:
+    // Constructor, expanding the seed through splitmix64
+    constexpr explicit xoshiro256 (uint64_t seed = 0) : s_{} {
+      this->seed(seed);
+    }
+
+    constexpr void seed (uint64_t seed) {
+      for (uint64_t& s : this->s_) {
+        s = splitmix64(seed);
+      }
+    }
+
+    constexpr result_type operator () (void) {
+      return xoshiro256::step(this->s_[0], this->s_[1], this->s_[2], this->s_[3]);
+    }
+
+    // Advances the state by 2^128 steps, to get non-overlapping streams
+    constexpr void jump (void) {
+      constexpr uint64_t table[] = {
+        UINT64_C(0x180EC6D33CFD0ABA), UINT64_C(0xD5A61266F0C9392C),
+        UINT64_C(0xA9582618E03FC9AA), UINT64_C(0x39ABDC4529B1661C)
+      };
+
+      uint64_t s[4] = { 0, 0, 0, 0 };
+
+      for (uint64_t const jump : table) {
+        for (int b = 0; b < 64; ++b) {
+          if (jump & (UINT64_C(1) << b)) {
+            for (int i = 0; i < 4; ++i) {
+              s[i] ^= this->s_[i];
+            }
+          }
+
+          (*this)();
+        }
+      }
+
+      for (int i = 0; i < 4; ++i) {
+        this->s_[i] = s[i];
+      }
+    }
+
+    // Discards <count> outputs
+    constexpr void discard (uint64_t count) {
+      for (; count; --count) {
+        (*this)();
+      }
+    }
+
+    bool operator == (xoshiro256 const& ot) const {
+      return std::equal(this->s_, this->s_ + 4, ot.s_);
+    }
+
+    bool operator != (xoshiro256 const& ot) const { return !(*this == ot); }
+  };
+
+  // Philox4x64-10 counter-based generator, usable as a standard random engine
+  // Each output block is a keyed bijection of a 256-bit counter, so any
+  // stream position is reached directly: a stream keyed by a seed and
+  // addressed by (generation, individual, purpose) gives the same numbers
+  // on whichever thread draws them
+  // Thanks to Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"
+  class philox {
+   public:
+    using result_type = uint64_t;
+    using ctr_t = std::array<uint64_t, 4>;
+    using key_t = std::array<uint64_t, 2>;
+
+    static constexpr result_type min (void) { return 0; }
+    static constexpr result_type max (void) {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    // Number of rounds of the bijection
+    static constexpr int rounds = 10;
+
+    // Computes the output block of a counter
+    static constexpr ctr_t block (ctr_t ctr, key_t key) {
+      constexpr uint64_t m0 = UINT64_C(0xD2E7470EE14C6C93);
+      constexpr uint64_t m1 = UINT64_C(0xCA5A826395121157);
+      constexpr uint64_t w0 = UINT64_C(0x9E3779B97F4A7C15);
+      constexpr uint64_t w1 = UINT64_C(0xBB67AE8584CAA73B);
+
+      for (int r = 0; r < rounds; ++r) {
+        unsigned __int128 const p0 = static_cast<unsigned __int128>(m0) * ctr[0];
+        unsigned __int128 const p1 = static_cast<unsigned __int128>(m1) * ctr[2];
+
+        ctr = {
+          static_cast<uint64_t>(p1 >> 64) ^ ctr[1] ^ key[0],
+          static_cast<uint64_t>(p1),
+          static_cast<uint64_t>(p0 >> 64) ^ ctr[3] ^ key[1],
+          static_cast<uint64_t>(p0)
+        };
+
+        key[0] += w0;
+        key[1] += w1;
+      }
+
+      return ctr;
+    }
+
+   private:
+    // Counter of the next block, whose first word is the block index
+    ctr_t ctr_{};
+    key_t key_{};
+    // Current block and the position of its next output
+    ctr_t out_{};
+    unsigned pos_ = 4;
+
+   public:
+    // Constructor, with a stream addressed by three words
+    constexpr explicit philox (
+      uint64_t seed = 0, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0
+    ) : ctr_{ 0, a, b, c }, key_{ seed, 0 } {}
+
+    constexpr void seed (uint64_t seed) { *this = philox{ seed }; }
+
+    constexpr result_type operator () (void) {
+      if (this->pos_ == 4) {
+        this->out_ = philox::block(this->ctr_, this->key_);
+        this->ctr_[0] += 1;
+        this->pos_ = 0;
+      }
+
+      return this->out_[this->pos_++];
+    }
+
+    // Discards <count> outputs, in constant time
+    constexpr void discard (uint64_t count) {
+      uint64_t const left = 4 - this->pos_;
+
+      if (count <= left) {
+        this->pos_ += count;
+        return;
+      }
+
+      count -= left;
+      this->ctr_[0] += count / 4;
+      this->pos_ = 4;
+
+      if (count % 4) {
+        (*this)();
+        this->pos_ = count % 4;
+      }
+    }
+
+    bool operator == (philox const& ot) const {
+      return this->ctr_ == ot.ctr_ and this->key_ == ot.key_
+        and this->pos_ == ot.pos_;
+    }
+
+    bool operator != (philox const& ot) const { return !(*this == ot); }
+  };
+
+};
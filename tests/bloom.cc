@@ -0,0 +1,92 @@
+#include <memory>
+#include "../bitset.hh"
+#include "../random.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+using hsh_t = bitset_bloom::hsh_t;
+
+// Distinct hashes of <count> elements, from a seed
+static std::vector<hsh_t> make_hashes (siz_t count, uint64_t seed) {
+  std::vector<hsh_t> hashes(count);
+
+  for (hsh_t& h : hashes) {
+    h = util::random::splitmix64(seed);
+  }
+
+  return hashes;
+}
+
+TEST(bloom_no_false_negatives) {
+  bitset_bloom filter = bitset_bloom::sized(10000, 0.01);
+  std::vector<hsh_t> const in = make_hashes(10000, 1);
+
+  for (hsh_t const h : in) {
+    filter.insert(h);
+  }
+
+  for (hsh_t const h : in) {
+    CHECK(filter.contains(h));
+  }
+}
+
+TEST(bloom_false_positive_rate) {
+  constexpr double rate = 0.01;
+  bitset_bloom filter = bitset_bloom::sized(20000, rate);
+  std::vector<hsh_t> const in = make_hashes(20000, 2);
+  std::vector<hsh_t> const out = make_hashes(100000, 3);
+
+  filter.insert(in.data(), in.size());
+
+  siz_t positives = 0;
+
+  for (hsh_t const h : out) {
+    positives += filter.contains(h);
+  }
+
+  // Blocking costs some accuracy, but stays close to the target
+  CHECK(positives < 3 * rate * out.size());
+
+  double const estimate = filter.estimate();
+  CHECK(std::fabs(estimate - in.size()) < 0.05 * in.size());
+}
+
+TEST(bloom_batch_matches_single) {
+  bitset_bloom batch{ 1 << 16, 5 }, single{ 1 << 16, 5 };
+  std::vector<hsh_t> const in = make_hashes(3000, 4);
+  std::vector<hsh_t> const probe = make_hashes(5000, 5);
+
+  batch.insert(in.data(), in.size());
+
+  for (hsh_t const h : in) {
+    single.insert(h);
+  }
+
+  CHECK(batch.bits() == single.bits());
+
+  std::unique_ptr<bool[]> found{ new bool[probe.size()] };
+  batch.contains(probe.data(), probe.size(), found.get());
+
+  for (siz_t i = 0; i < probe.size(); ++i) {
+    CHECK(found[i] == single.contains(probe[i]));
+  }
+}
+
+TEST(bloom_insert_new_and_merge) {
+  bitset_bloom a{ 1 << 14, 4 }, b{ 1 << 14, 4 };
+  std::vector<hsh_t> const in = make_hashes(200, 6);
+
+  for (siz_t i = 0; i < in.size(); ++i) {
+    bitset_bloom& half = (i % 2) ? a : b;
+
+    // The first insertion may be a false positive, the second never is new
+    half.insert_new(in[i]);
+    CHECK(half.insert_new(in[i]));
+  }
+
+  a |= b;
+
+  for (hsh_t const h : in) {
+    CHECK(a.contains(h));
+  }
+}
@@ -0,0 +1,216 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../evolution.hh"
+#include "test.hh"
+
+namespace evo = util::evolution;
+
+using int_cache = evo::fitness_cache<int, int>;
+using genetic_t = evo::genetic<bitset, uintmax_t>;
+using base_t = genetic_t::evo_t;
+using gens = evo::bitset_generators<base_t>;
+using base_gens = evo::base_generators<base_t>;
+
+static bool cached (int_cache& cache, int key) {
+  int fit;
+  return cache.find(key, fit) and fit == key * 2;
+}
+
+// Onemax on <bits> bits, with an evaluator counting its calls
+static void setup (base_t& e, bitset::siz_t bits, std::atomic<uintmax_t>& calls) {
+  e.set_creator([ bits ] (base_t& ev) { return bitset::random(bits, ev.random()); });
+  e.set_evaluator([ &calls ] (bitset& c) {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    return uintmax_t(c.size() - c.popcount());
+  });
+  e.set_comparator([] (uintmax_t a, uintmax_t b) { return a < b; });
+  e.set_generator(base_gens::always_cross(
+    gens::uniform_cross(gens::tournament(2)), gens::uniform(), 0.5
+  ));
+}
+
+static bool consistent (base_t const& e) {
+  for (base_t::siz_t i = 0; i < e.size(); ++i) {
+    if (e.fit_at(i) != e.chr_at(i).size() - e.chr_at(i).popcount()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// A full shard replaces the first entry not referenced since the hand
+// last passed it, clearing the references on the way (lookups reference
+// the entries they hit, so the checks below only look for evicted keys)
+TEST(cache_clock_eviction) {
+  int_cache cache{ 4, 1 };
+
+  for (int key : { 1, 2, 3, 4 }) {
+    cache.insert(key, key * 2);
+  }
+
+  CHECK(cache.size() == 4);
+  CHECK(cached(cache, 1));
+
+  // 1 is referenced, so the hand clears it and takes 2
+  cache.insert(5, 10);
+  CHECK(!cached(cache, 2));
+
+  // The hand resumes after 5, so 3 and then 4 go
+  cache.insert(6, 12);
+  CHECK(!cached(cache, 3));
+  cache.insert(7, 14);
+  CHECK(!cached(cache, 4));
+
+  // The hand wraps to 1, whose reference is gone, and then skips the
+  // referenced 5 to take 6
+  CHECK(cached(cache, 5));
+  cache.insert(8, 16);
+  CHECK(!cached(cache, 1));
+  cache.insert(9, 18);
+  CHECK(!cached(cache, 6));
+
+  CHECK(cache.size() == 4);
+  CHECK(cached(cache, 5) and cached(cache, 7) and cached(cache, 8) and cached(cache, 9));
+
+  // Updating a stored entry does not evict
+  cache.insert(8, 16);
+  CHECK(cache.size() == 4 and cached(cache, 7));
+}
+
+TEST(cache_within_capacity) {
+  for (auto const& [ capacity, shards ] : { std::pair{ 10, 16 }, std::pair{ 100, 7 }, std::pair{ 64, 1 } }) {
+    int_cache cache{ int_cache::siz_t(capacity), int_cache::siz_t(shards) };
+
+    for (int key = 0; key < 10000; ++key) {
+      cache.insert(key, key * 2);
+      CHECK(cache.size() <= cache.capacity());
+    }
+
+    // Every shard got keys enough to fill it
+    CHECK(cache.size() == cache.capacity());
+  }
+}
+
+// A zero capacity disables the cache, computing every lookup
+TEST(cache_zero_capacity) {
+  int_cache cache{ 0, 4 };
+  uintmax_t computed = 0;
+
+  for (int i = 0; i < 100; ++i) {
+    int key = i % 3;
+    CHECK(cache.get(key, [ & ] (int& k) { ++computed; return k * 2; }) == key * 2);
+  }
+
+  CHECK(cache.size() == 0);
+  CHECK(computed == 100);
+  CHECK(cache.hits() == 0 and cache.misses() == 100);
+}
+
+TEST(cache_concurrent_get) {
+  int_cache cache{ 200, 4 };
+  std::atomic<uintmax_t> computed{ 0 };
+  std::atomic<bool> wrong{ false };
+  int const lookups = 100000;
+
+  IF_OMP(parallel for schedule(dynamic, 64))
+  for (int i = 0; i < lookups; ++i) {
+    // Half of the lookups go to 50 hot keys, the rest cycle through 500
+    int key = (i * 7919) % (i % 2 ? 500 : 50);
+    int const fit = cache.get(key, [ & ] (int& k) {
+      computed.fetch_add(1, std::memory_order_relaxed);
+      return k * 2;
+    });
+
+    if (fit != key * 2) {
+      wrong = true;
+    }
+  }
+
+  CHECK(!wrong);
+  CHECK(cache.hits() + cache.misses() == uintmax_t(lookups));
+  CHECK(computed == cache.misses());
+  CHECK(cache.hits() > 0);
+  CHECK(cache.size() <= cache.capacity());
+
+  cache.clear();
+  CHECK(cache.size() == 0 and cache.hits() == 0 and cache.misses() == 0);
+}
+
+// Parallel evaluations look up every chromosome once, and only misses
+// reach the evaluator
+TEST(cache_parallel_evaluate) {
+  auto cache = std::make_shared<genetic_t::cache_t>(64, 8);
+  std::atomic<uintmax_t> calls{ 0 };
+  genetic_t e{ 1000, 3 };
+
+  setup(e, 8, calls);
+  e.set_cache(cache);
+  e.set_parallel(true);
+  e.populate(1000);
+
+  uintmax_t lookups = 1000;
+
+  for (int round = 0; round < 5; ++round) {
+    std::vector<bitset> chrs;
+
+    for (int i = 0; i < 1000; ++i) {
+      chrs.push_back(bitset::random(8, e.random()));
+    }
+
+    e.set(0, std::move(chrs));
+    lookups += 1000;
+  }
+
+  CHECK(cache->hits() + cache->misses() == lookups);
+  CHECK(calls == cache->misses());
+  CHECK(cache->hits() > 0);
+  CHECK(cache->size() <= cache->capacity());
+  CHECK(consistent(e));
+}
+
+// Islands sharing a cache see each other's evaluations, also while
+// stepping concurrently
+TEST(cache_shared_by_islands) {
+  auto cache = std::make_shared<genetic_t::cache_t>(1 << 12);
+  std::atomic<uintmax_t> calls{ 0 };
+  evo::islands<bitset, uintmax_t> isl{ 4, 1 };
+
+  for (base_t::siz_t i = 0; i < isl.size(); ++i) {
+    isl.emplace_at<genetic_t>(i, 32, i);
+    setup(isl[i], 12, calls);
+    isl[i].set_cache(cache);
+  }
+
+  isl[0].populate(32);
+  isl[1].populate(32);
+
+  // Copies of the first island's chromosomes are all hits for the second
+  uintmax_t const hits = cache->hits(), evaluated = calls;
+  std::vector<bitset> chrs;
+
+  for (base_t::siz_t i = 0; i < isl[0].size(); ++i) {
+    chrs.push_back(isl[0].chr_at(i).copy());
+  }
+
+  isl[1].set(0, std::move(chrs));
+
+  CHECK(cache->hits() - hits == 32);
+  CHECK(calls == evaluated);
+
+  for (base_t::siz_t i = 2; i < isl.size(); ++i) {
+    isl[i].populate(32);
+  }
+
+  for (int round = 0; round < 20; ++round) {
+    isl.step(true);
+  }
+
+  CHECK(calls == cache->misses());
+  CHECK(cache->size() <= cache->capacity());
+
+  for (base_t::siz_t i = 0; i < isl.size(); ++i) {
+    CHECK(consistent(isl[i]));
+  }
+}
@@ -0,0 +1,119 @@
+#include <vector>
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+using bck_t = bitset::bck_t;
+
+static siz_t const sizes[] = { 1, 2, 63, 64, 65, 127, 128, 129, 1000, 100003 };
+static siz_t const thresholds[] = { 0, 3, 5, 6 };
+
+// <n> random bitsets of <size> bits, every other one inverted, so that
+// the buckets past the size hold ones
+static std::vector<bitset> inputs (siz_t size, siz_t n, uint64_t seed) {
+  std::vector<bitset> bsets;
+
+  for (siz_t i = 0; i < n; ++i) {
+    bitset bs = bitset::random(size, 0.5, seed * 131 + i);
+    bsets.push_back(i % 2 ? ~bs : std::move(bs));
+  }
+
+  return bsets;
+}
+
+// Number of bitsets with each position set, one bit at a time
+static std::vector<siz_t> naive (std::vector<bitset> const& bsets, siz_t size) {
+  std::vector<siz_t> counts(size, 0);
+
+  for (bitset const& bs : bsets) {
+    for (siz_t pos = 0; pos < size; ++pos) {
+      counts[pos] += bs.get(pos);
+    }
+  }
+
+  return counts;
+}
+
+TEST(counter_accumulate_compare) {
+  for (siz_t const size : { 1, 63, 64, 65, 200 }) {
+    for (siz_t n = 1; n <= 9; ++n) {
+      std::vector<bitset> const bsets = inputs(size, n, n);
+      std::vector<siz_t> const counts = naive(bsets, size);
+      bitset const& first = bsets[0];
+
+      for (siz_t j = 0; j < first.buckets(); ++j) {
+        bck_t const mask = j == first.buckets() - 1 ? first.last_mask() : ~bck_t{ 0 };
+        bck_t pl[bitset::bits] = {};
+        siz_t np = bitset_counter::accumulate(bsets.data(), n, j, mask, pl, 0);
+
+        CHECK(np <= bitset_counter::planes_for(n));
+
+        // Accumulating again onto the planes doubles every counter
+        for (siz_t const times : { 1, 2 }) {
+          siz_t const stop = std::min(size - j * bitset::bits, bitset::bits);
+
+          for (siz_t b = 0; b < stop; ++b) {
+            siz_t value = 0;
+
+            for (siz_t p = 0; p < np; ++p) {
+              value |= ((pl[p] >> b) & 1) << p;
+            }
+
+            CHECK(value == times * counts[j * bitset::bits + b]);
+
+            for (siz_t const k : thresholds) {
+              bool const reached = (bitset_counter::compare(pl, np, k) >> b) & 1;
+              CHECK(reached == (value >= k));
+            }
+          }
+
+          // Bits past the size are masked out, even from inverted inputs
+          for (siz_t p = 0; p < np; ++p) {
+            CHECK((pl[p] & ~mask) == 0);
+          }
+
+          np = bitset_counter::accumulate(bsets.data(), n, j, mask, pl, np);
+        }
+      }
+    }
+  }
+}
+
+TEST(counter_at_least) {
+  for (siz_t const size : sizes) {
+    for (siz_t const n : { 1, 4, 7, 9 }) {
+      std::vector<bitset> const bsets = inputs(size, n, size + n);
+      std::vector<siz_t> const counts = naive(bsets, size);
+
+      std::vector<siz_t> out(size);
+      bitset_counter::counts(bsets.data(), n, out.data());
+      CHECK(out == counts);
+
+      bitset_counter counter{ size };
+      counter.add(bsets.data(), n);
+      CHECK(counter.count() == n);
+
+      for (siz_t const k : thresholds) {
+        bitset const fast = bitset_counter::at_least(bsets.data(), n, k);
+        bitset const added = counter.at_least(k);
+        siz_t expected = 0;
+        bool same = fast.size() == size and added.size() == size;
+
+        for (siz_t pos = 0; pos < size and same; ++pos) {
+          bool const reached = counts[pos] >= k;
+          expected += reached;
+          same = fast.get(pos) == reached and added.get(pos) == reached;
+        }
+
+        CHECK(same);
+        CHECK(fast.popcount() == expected and added.popcount() == expected);
+      }
+    }
+  }
+}
+
+TEST(counter_empty_input) {
+  bitset const bs = bitset::random(10, 0.5, 1);
+  CHECK_THROWS(bitset_counter::at_least(&bs, 0, 1), std::invalid_argument);
+  CHECK_THROWS(bitset_counter::majority(&bs, 0), std::invalid_argument);
+}
@@ -0,0 +1,224 @@
+#include <random>
+#include <vector>
+#include "../evolution.hh"
+#include "test.hh"
+
+namespace evo = util::evolution;
+
+using genetic_t = evo::genetic<bitset, uintmax_t>;
+using gens = evo::bitset_generators<genetic_t::evo_t>;
+using siz_t = bitset::siz_t;
+
+static siz_t const sizes[] = { 1, 2, 63, 64, 65, 128, 1000, 4099 };
+
+// Bit by bit, where the mask is set the children take the other parent
+static bool crossed (
+  bitset const& a, bitset const& b, bitset const& c1, bitset const& c2,
+  bitset const& mask
+) {
+  if (c1.size() != a.size() or c2.size() != a.size()) {
+    return false;
+  }
+
+  siz_t ones1 = 0, ones2 = 0;
+
+  for (siz_t i = 0; i < a.size(); ++i) {
+    bool const swap = mask.get(i);
+
+    if (c1.get(i) != (swap ? b.get(i) : a.get(i)) or
+        c2.get(i) != (swap ? a.get(i) : b.get(i))) {
+      return false;
+    }
+
+    ones1 += c1.get(i);
+    ones2 += c2.get(i);
+  }
+
+  return c1.popcount() == ones1 and c2.popcount() == ones2;
+}
+
+// Mask swapping after an odd number of the sorted points
+static bitset points_mask (siz_t size, std::vector<siz_t> const& points) {
+  bitset mask{ size };
+  bool swap = false;
+
+  for (siz_t i = 0, p = 0; i < size; ++i) {
+    for (; p < points.size() and points[p] == i; ++p) {
+      swap = !swap;
+    }
+
+    if (swap) {
+      mask.set(i);
+    }
+  }
+
+  return mask;
+}
+
+// Parents, plain and inverted, whose buckets past the size hold ones
+static std::vector<std::pair<bitset, bitset>> parents (siz_t size) {
+  bitset const a = bitset::random(size, 0.5, size);
+  bitset const b = bitset::random(size, 0.5, size + 1);
+
+  return {
+    { a.copy(), b.copy() },
+    { ~a.copy(), b.copy() },
+    { ~a.copy(), ~b.copy() },
+    { a.copy(), ~a.copy() }
+  };
+}
+
+TEST(crossover_mask) {
+  for (siz_t const size : sizes) {
+    bitset none{ size }, all{ size }, head{ size };
+    all.flip();
+    head.set(0);
+
+    std::vector<bitset> masks;
+    masks.push_back(std::move(none));
+    masks.push_back(std::move(all));
+    masks.push_back(std::move(head));
+    masks.push_back(bitset::random(size, 0.5, size + 2));
+    masks.push_back(~bitset::random(size, 0.1, size + 3));
+
+    for (auto const& [ a, b ] : parents(size)) {
+      for (bitset const& mask : masks) {
+        bitset c1, c2;
+        bitset::crossover(a, b, mask, c1, c2);
+        CHECK(crossed(a, b, c1, c2, mask));
+      }
+    }
+  }
+}
+
+TEST(crossover_points) {
+  std::mt19937_64 rnd{ 7 };
+
+  for (siz_t const size : sizes) {
+    std::vector<std::vector<siz_t>> cases{ {}, { 0 }, { size - 1 }, { 0, size - 1 } };
+
+    // Points on both sides of the bucket boundaries, and repeated ones
+    // cancelling each other
+    if (size > 64) {
+      cases.push_back({ 63, 64 });
+      cases.push_back({ 1, 64, 65 });
+      cases.push_back({ 5, 5, 70 });
+    }
+
+    for (siz_t const count : { 1, 3, 10 }) {
+      cases.push_back(gens::cross_points(size, count, rnd));
+    }
+
+    for (auto const& [ a, b ] : parents(size)) {
+      for (std::vector<siz_t> const& points : cases) {
+        bitset c1, c2;
+        bitset::crossover(a, b, points.data(), points.size(), c1, c2);
+        CHECK(crossed(a, b, c1, c2, points_mask(size, points)));
+      }
+    }
+  }
+}
+
+// Children keep their storage when it is not shared, while shared or
+// mismatched storage is replaced, leaving the other owners untouched
+TEST(crossover_storage_reuse) {
+  siz_t const size = 1000;
+  bitset const a = bitset::random(size, 0.5, 1);
+  bitset const b = bitset::random(size, 0.5, 2);
+  bitset const mask = bitset::random(size, 0.5, 3);
+
+  // Stale inverted children are overwritten in place
+  bitset c1 = ~bitset::random(size, 0.5, 4), c2 = bitset::random(size, 0.5, 5);
+  auto const storage = [] (bitset const& bs) { return bs.data(); };
+  bitset::bck_t const* d1 = storage(c1);
+  bitset::bck_t const* d2 = storage(c2);
+
+  bitset::crossover(a, b, mask, c1, c2);
+  CHECK(crossed(a, b, c1, c2, mask));
+  CHECK(storage(c1) == d1 and storage(c2) == d2);
+
+  std::vector<siz_t> const points{ 10, 300, 999 };
+  bitset::crossover(a, b, points.data(), points.size(), c1, c2);
+  CHECK(crossed(a, b, c1, c2, points_mask(size, points)));
+  CHECK(storage(c1) == d1 and storage(c2) == d2);
+
+  // Children sharing storage with the parents
+  bitset x = a.copy(), y = b.copy();
+  bitset const shared = x;
+
+  bitset::crossover(x, y, mask, x, y);
+  CHECK(crossed(a, b, x, y, mask));
+  CHECK(shared == a);
+
+  // Children of another size
+  bitset small{ 10 }, large{ 5000 };
+  bitset::crossover(a, b, mask, small, large);
+  CHECK(crossed(a, b, small, large, mask));
+}
+
+TEST(crossover_half_mask) {
+  std::mt19937_64 rnd{ 11 };
+
+  for (siz_t const size : sizes) {
+    for (auto const& [ a, b ] : parents(size)) {
+      bitset diff;
+      bitset::XOR(a, b, diff);
+
+      for (int rep = 0; rep < 5; ++rep) {
+        bitset const mask = gens::half_mask(a, b, rnd);
+        bitset outside;
+        bitset::AND(mask, ~bitset{ diff }, outside);
+
+        CHECK(mask.size() == size);
+        CHECK(mask.popcount() == diff.popcount() / 2);
+        CHECK(outside.popcount() == 0);
+      }
+    }
+  }
+}
+
+// The generators cross the selected parents, with a mask that can be read
+// back from the children
+TEST(crossover_generators) {
+  genetic_t e{ 2, 13 };
+  bitset const a = bitset::random(777, 0.5, 14);
+  bitset const b = ~a.copy();
+
+  e.add(a.copy(), 0);
+  e.add(b.copy(), 0);
+
+  siz_t next = 0;
+  gens::selector const alternate = [ &next ] (genetic_t::evo_t&) { return next++ % 2; };
+
+  // With complementary parents every bit differs, so the mask is c1 ^ a
+  auto const mask_of = [ & ] (genetic_t::chr_v const& children) {
+    bitset mask;
+    bitset::XOR(children[0], a, mask);
+    return mask;
+  };
+
+  for (int rep = 0; rep < 10; ++rep) {
+    genetic_t::chr_v const uniform = gens::uniform_cross(alternate)(e);
+    bitset const umask = mask_of(uniform);
+    CHECK(uniform.size() == 2 and crossed(a, b, uniform[0], uniform[1], umask));
+    CHECK(umask.popcount() > 777 / 4 and umask.popcount() < 3 * 777 / 4);
+
+    genetic_t::chr_v const half = gens::half_uniform_cross(alternate)(e);
+    bitset const hmask = mask_of(half);
+    CHECK(crossed(a, b, half[0], half[1], hmask));
+    CHECK(hmask.popcount() == 777 / 2);
+
+    genetic_t::chr_v const points = gens::points_cross(5, alternate)(e);
+    bitset const pmask = mask_of(points);
+    CHECK(crossed(a, b, points[0], points[1], pmask));
+
+    // Five distinct points in [1, size) switch the parents five times
+    siz_t switches = 0;
+
+    for (siz_t i = 1; i < 777; ++i) {
+      switches += pmask.get(i) != pmask.get(i - 1);
+    }
+
+    CHECK(!pmask.get(0) and switches == 5);
+  }
+}
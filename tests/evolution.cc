@@ -0,0 +1,93 @@
+#include <vector>
+#include "../evolution.hh"
+#include "test.hh"
+
+namespace evo = util::evolution;
+
+using vec_chr = std::vector<int>;
+using vec_fit = std::vector<double>;
+
+// Every member of the algorithms is compiled, not only those used below
+template class evo::genetic<bitset, uintmax_t>;
+template class evo::steady_state<bitset, uintmax_t>;
+template class evo::one_lambda<bitset, uintmax_t>;
+template class evo::clonalg<bitset, uintmax_t>;
+template class evo::islands<bitset, uintmax_t>;
+template class evo::nsga<vec_chr, vec_fit>;
+template class evo::nsais<vec_chr, vec_fit>;
+template class evo::nsga_steady<vec_chr, vec_fit>;
+template class evo::nsga_steady<bitset, vec_fit>;
+template class evo::fitness_cache<bitset, uintmax_t>;
+template class evo::base_generators<evo::base<bitset, uintmax_t>>;
+template class evo::bitset_generators<evo::base<bitset, uintmax_t>>;
+
+using steady = evo::steady_state<bitset, uintmax_t>;
+using steady_gens = evo::bitset_generators<steady::evo_t>;
+
+// Onemax on <bits> bits, as the number of zeros to be minimized
+static void setup_onemax (steady& e, bitset::siz_t bits) {
+  e.set_creator([ bits ] (steady::evo_t& ev) {
+    return bitset::random(bits, ev.random());
+  });
+  e.set_evaluator([] (bitset& c) { return uintmax_t(c.size() - c.popcount()); });
+  e.set_comparator([] (uintmax_t a, uintmax_t b) { return a < b; });
+  e.set_generator(evo::base_generators<steady::evo_t>::always_cross(
+    steady_gens::uniform_cross(steady_gens::tournament(2)),
+    steady_gens::uniform(), 0.5
+  ));
+}
+
+TEST(steady_state_run_converges) {
+  for (auto const rep : { steady::replacement::worst, steady::replacement::tournament }) {
+    for (steady::siz_t const threads : { 1, 4 }) {
+      steady e{ 32, 1 };
+
+      e.set_replacement(rep, 4);
+      setup_onemax(e, 128);
+      e.populate(32);
+
+      uintmax_t const start = e.best_fit();
+      e.run(20000, threads);
+
+      CHECK(e.evaluations() == 20000);
+      CHECK(e.accepted() > 0 and e.accepted() <= e.evaluations());
+      CHECK(e.size() == 32);
+      CHECK(e.best_fit() < start / 4);
+
+      for (steady::siz_t i = 0; i < e.size(); ++i) {
+        CHECK(e.fit_at(i) == e.chr_at(i).size() - e.chr_at(i).popcount());
+      }
+    }
+  }
+}
+
+TEST(islands_copy_move) {
+  evo::islands<bitset, uintmax_t> isl{ 3, 1 };
+
+  for (steady::siz_t i = 0; i < isl.size(); ++i) {
+    isl.emplace_at<steady>(i, 16, i);
+    setup_onemax(isl.world<steady>(i), 64);
+    isl[i].populate(16);
+  }
+
+  isl.step(false);
+  isl.migrate_move(4, false);
+
+  evo::islands<bitset, uintmax_t> copy{ isl };
+
+  for (steady::siz_t i = 0; i < isl.size(); ++i) {
+    CHECK(&copy[i] != &isl[i]);
+    CHECK(copy[i].size() == isl[i].size());
+    CHECK(copy[i].best_fit() == isl[i].best_fit());
+  }
+
+  copy = isl;
+  evo::islands<bitset, uintmax_t> moved{ std::move(copy) };
+
+  CHECK(moved.size() == 3 and copy.size() == 0);
+  CHECK(moved.world<steady>(2).popsize() == 16);
+
+  moved.step(false);
+  moved = std::move(isl);
+  CHECK(moved.size() == 3 and isl.size() == 0);
+}
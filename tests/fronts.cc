@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../evolution/nsga/fronts.hh"
+#include "pareto.hh"
+#include "test.hh"
+
+using util::evolution::front_index;
+using siz_t = front_index::siz_t;
+
+// Points of two or three objectives on a small grid, so that they tie
+struct points {
+  std::vector<std::vector<int>> value;
+
+  bool operator () (siz_t a, siz_t b) const {
+    return tests::dominates(value[a], value[b]);
+  }
+};
+
+// The index agrees with the brute force ranks, and fronts outside the
+// returned range kept their ranks
+static void check (
+  front_index const& index, points const& dom, std::vector<siz_t> const& live,
+  std::vector<siz_t>& ranks, front_index::range const& changed
+) {
+  std::vector<siz_t> const expected = tests::peel_ranks(live, dom.value.size(), dom);
+  siz_t members = 0;
+
+  for (siz_t k = 0; k < index.size(); ++k) {
+    CHECK(!index.front(k).empty());
+    members += index.front(k).size();
+
+    for (siz_t const pos : index.front(k)) {
+      CHECK(index.rank(pos) == k);
+    }
+  }
+
+  CHECK(members == live.size());
+
+  for (siz_t const pos : live) {
+    CHECK(index.rank(pos) == expected[pos]);
+
+    bool const moved = ranks[pos] != expected[pos];
+    bool const inside = expected[pos] >= changed.first and expected[pos] < changed.second;
+
+    CHECK(!moved or inside or ranks[pos] == siz_t(-1));
+    ranks[pos] = expected[pos];
+  }
+}
+
+TEST(front_index_matches_brute_force) {
+  for (siz_t const dims : { 2, 3 }) {
+    for (int const grid : { 4, 30 }) {
+      std::mt19937_64 rnd{ dims * 100 + grid };
+      points dom;
+      front_index index;
+      std::vector<siz_t> live, ranks;
+
+      // Positions are never reused, except through rename
+      auto const fresh = [ & ] (void) {
+        dom.value.emplace_back(dims);
+
+        for (int& x : dom.value.back()) {
+          x = rnd() % grid;
+        }
+
+        ranks.push_back(siz_t(-1));
+        return dom.value.size() - 1;
+      };
+
+      for (siz_t step = 0; step < 1500; ++step) {
+        siz_t const op = rnd() % 8;
+
+        if (live.size() < 40 or (op < 4 and live.size() < 120)) {
+          siz_t const pos = fresh();
+          front_index::range const changed = index.insert(pos, dom);
+
+          CHECK(changed.first == index.rank(pos));
+          live.push_back(pos);
+          check(index, dom, live, ranks, changed);
+        } else if (op < 7) {
+          siz_t const at = rnd() % live.size();
+          front_index::range const changed = index.remove(live[at], dom);
+
+          live.erase(live.begin() + at);
+          check(index, dom, live, ranks, changed);
+        } else {
+          // A position takes a new place, keeping its value
+          siz_t const at = rnd() % live.size();
+          siz_t const to = fresh();
+
+          dom.value[to] = dom.value[live[at]];
+          ranks[to] = ranks[live[at]];
+          index.rename(live[at], to);
+          live[at] = to;
+          check(index, dom, live, ranks, { 0, 0 });
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,68 @@
+#include <gmpxx.h>
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+
+// Integer of the bits of a bitset, one bit at a time
+static mpz_class naive (bitset const& bs) {
+  mpz_class value;
+
+  for (siz_t i = bs.size(); i-- > 0; ) {
+    value = value * 2 + (bs.get(i) ? 1 : 0);
+  }
+
+  return value;
+}
+
+TEST(gmp_empty) {
+  bitset const none;
+  bitset const zero{ 0 };
+
+  for (bitset const* bs : { &none, &zero }) {
+    bitset::mpz_view const view{ *bs };
+
+    CHECK(mpz_sgn(view.get()) == 0);
+    CHECK(static_cast<mpz_class>(*bs) == 0);
+  }
+}
+
+TEST(gmp_view_matches_bits) {
+  for (siz_t const size : { 1, 63, 64, 65, 128, 1000 }) {
+    bitset const bs = bitset::random(size, 0.5, size);
+    mpz_class const expected = naive(bs);
+
+    bitset::mpz_view const view{ bs };
+    CHECK(mpz_cmp(view.get(), expected.get_mpz_t()) == 0);
+    CHECK(static_cast<mpz_class>(bs) == expected);
+
+    // Inverted bitsets are copied, without the bits past size
+    bitset const inv = ~bitset{ bs };
+    mpz_class const inv_expected = naive(inv);
+
+    CHECK(inv.inverted());
+    CHECK(inv_expected == (mpz_class{ 1 } << size) - 1 - expected);
+
+    bitset::mpz_view const inv_view{ inv };
+    CHECK(mpz_cmp(inv_view.get(), inv_expected.get_mpz_t()) == 0);
+    CHECK(static_cast<mpz_class>(inv) == inv_expected);
+  }
+}
+
+TEST(gmp_round_trip) {
+  for (siz_t const size : { 1, 63, 64, 65, 128, 1000 }) {
+    bitset const bs = bitset::random(size, 0.5, size + 1);
+    bitset const back{ static_cast<mpz_class>(bs), size };
+
+    CHECK(back == bs);
+    CHECK(back.popcount() == bs.popcount());
+
+    // Wider values are truncated, narrower ones padded with zeros
+    mpz_class const value = static_cast<mpz_class>(bs);
+    mpz_class const wide = value + (mpz_class{ 5 } << size);
+
+    CHECK(bitset(wide, size) == bs);
+    CHECK(static_cast<mpz_class>(bitset(value, size + 70)) == value);
+    CHECK(bitset(mpz_class{ 0 }, size).popcount() == 0);
+  }
+}
@@ -0,0 +1,168 @@
+#include <deque>
+#include <limits>
+#include <random>
+#include <vector>
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+using adjacency = std::vector<std::vector<siz_t>>;
+
+constexpr siz_t const unreachable = bitset_graph::unreachable;
+
+// Random directed graph of about <degree> edges per vertex, also kept as
+// adjacency lists
+static bitset_graph random_graph (
+  siz_t vertices, double degree, uint64_t seed, adjacency& adj
+) {
+  std::mt19937_64 rnd{ seed };
+  std::uniform_int_distribution<siz_t> vertex{ 0, vertices - 1 };
+  bitset_graph graph{ vertices };
+
+  adj.assign(vertices, {});
+
+  for (siz_t e = 0, stop = siz_t(degree * vertices); e < stop; ++e) {
+    siz_t const u = vertex(rnd), v = vertex(rnd);
+
+    if (!graph.has_edge(u, v)) {
+      graph.add_edge(u, v);
+      adj[u].push_back(v);
+    }
+  }
+
+  return graph;
+}
+
+// Distances from a set of sources, with a queue
+static std::vector<siz_t> naive_bfs (
+  adjacency const& adj, std::vector<siz_t> const& sources
+) {
+  std::vector<siz_t> distance(adj.size(), unreachable);
+  std::deque<siz_t> queue;
+
+  for (siz_t const s : sources) {
+    if (distance[s] == unreachable) {
+      distance[s] = 0;
+      queue.push_back(s);
+    }
+  }
+
+  for (; !queue.empty(); queue.pop_front()) {
+    siz_t const u = queue.front();
+
+    for (siz_t const v : adj[u]) {
+      if (distance[v] == unreachable) {
+        distance[v] = distance[u] + 1;
+        queue.push_back(v);
+      }
+    }
+  }
+
+  return distance;
+}
+
+// Searches from a set of sources, checking reached vertices and distances
+// against the naive search
+static bool same_bfs (
+  bitset_graph const& graph, adjacency const& adj, std::vector<siz_t> const& sources,
+  bitset const& source_set
+) {
+  std::vector<siz_t> const expected = naive_bfs(adj, sources);
+  std::vector<siz_t> distance(graph.vertices());
+  bitset const reached = graph.bfs(source_set, distance.data());
+  siz_t count = 0;
+
+  for (siz_t v = 0; v < graph.vertices(); ++v) {
+    if (reached.get(v) != (expected[v] != unreachable)) {
+      return false;
+    }
+
+    count += reached.get(v);
+  }
+
+  return distance == expected and reached.popcount() == count;
+}
+
+// Switching parameters: mostly push (pulling only when the frontier has
+// more edges than the unexplored part, and leaving at once), always pull
+// after the sources, and the defaults
+static std::pair<siz_t, siz_t> const switches[] = {
+  { 1, 1 },
+  { std::numeric_limits<siz_t>::max(), std::numeric_limits<siz_t>::max() },
+  { 14, 24 }
+};
+
+// Vertices and average degree of the searched graphs: sparse, dense (so
+// the defaults also pull) and of a single bucket
+static std::pair<siz_t, double> const graphs[] = {
+  { 3001, 3.0 }, { 500, 40.0 }, { 64, 1.5 }
+};
+
+TEST(graph_bfs_distances) {
+  for (auto const& [ vertices, degree ] : graphs) {
+    adjacency adj;
+    bitset_graph graph = random_graph(vertices, degree, vertices, adj);
+    std::mt19937_64 rnd{ 1 };
+    std::uniform_int_distribution<siz_t> vertex{ 0, graph.vertices() - 1 };
+
+    for (auto const& [ alpha, beta ] : switches) {
+      graph.alpha() = alpha;
+      graph.beta() = beta;
+
+      for (int rep = 0; rep < 4; ++rep) {
+        siz_t const source = vertex(rnd);
+        std::vector<siz_t> const expected = naive_bfs(adj, { source });
+        std::vector<siz_t> distance(graph.vertices());
+        bitset const reached = graph.bfs(source, distance.data());
+
+        CHECK(distance == expected);
+        CHECK(reached.get(source));
+      }
+
+      // Several sources, given as a plain and as an inverted bitset
+      std::vector<siz_t> sources;
+      bitset set{ graph.vertices() };
+
+      for (int s = 0; s < 5; ++s) {
+        sources.push_back(vertex(rnd));
+        set.set(sources.back());
+      }
+
+      CHECK(same_bfs(graph, adj, sources, set));
+
+      bitset const inverted = ~bitset{ graph.vertices() };
+      std::vector<siz_t> all;
+
+      for (siz_t v = 0; v < graph.vertices(); ++v) {
+        all.push_back(v);
+      }
+
+      CHECK(same_bfs(graph, adj, all, inverted));
+      CHECK(same_bfs(graph, adj, {}, bitset{ graph.vertices() }));
+    }
+  }
+}
+
+TEST(graph_closure) {
+  // Warshall's algorithm is cubic, so the graphs are smaller
+  std::pair<siz_t, double> const sparse[] = { { 300, 1.2 }, { 129, 0.5 } };
+
+  for (auto const& [ vertices, degree ] : sparse) {
+    adjacency adj;
+    bitset_graph const graph = random_graph(vertices, degree, vertices + 1, adj);
+    bitset_graph const closure = graph.closure();
+    bool same = closure.vertices() == graph.vertices();
+
+    // Reachable through at least one edge, so from the out-neighbors
+    for (siz_t u = 0; u < graph.vertices() and same; ++u) {
+      std::vector<siz_t> const distance = naive_bfs(adj, adj[u]);
+
+      for (siz_t v = 0; v < graph.vertices() and same; ++v) {
+        bool const reachable = distance[v] != unreachable;
+        same = closure.has_edge(u, v) == reachable and closure.in(v).get(u) == reachable;
+      }
+    }
+
+    CHECK(same);
+  }
+}
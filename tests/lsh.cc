@@ -0,0 +1,94 @@
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+using metric = bitset_lsh::metric;
+
+// Index of <count> random bitsets of <size> bits
+static bitset_lsh make_index (
+  metric mtr, siz_t size, siz_t count, std::vector<bitset>& entries
+) {
+  bitset_lsh index{ size, mtr, 16, siz_t{ (mtr == metric::hamming) ? 16u : 4u }, 5 };
+
+  for (siz_t i = 0; i < count; ++i) {
+    entries.emplace_back(bitset::random(size, 0.3, 100 + i));
+    index.insert(entries.back());
+  }
+
+  return index;
+}
+
+TEST(lsh_query_zero) {
+  std::vector<bitset> entries;
+  bitset_lsh const index = make_index(metric::hamming, 512, 50, entries);
+
+  CHECK(index.query(entries[0], 0).empty());
+}
+
+TEST(lsh_exact_match) {
+  for (metric const mtr : { metric::hamming, metric::jaccard }) {
+    std::vector<bitset> entries;
+    bitset_lsh const index = make_index(mtr, 1024, 200, entries);
+
+    for (siz_t i = 0; i < entries.size(); i += 17) {
+      std::vector<bitset_lsh::match> const found = index.query(entries[i], 1);
+
+      CHECK(found.size() == 1);
+      CHECK(found[0].id == i);
+      CHECK(found[0].distance == 0.0);
+    }
+  }
+}
+
+TEST(lsh_ranking) {
+  std::vector<bitset> entries;
+  bitset_lsh const index = make_index(metric::hamming, 1024, 500, entries);
+
+  for (siz_t i = 0; i < 100; ++i) {
+    bitset query = entries[i].copy();
+
+    for (siz_t j = 0; j < 20; ++j) {
+      query.flip((i * 37 + j * 101) % query.size());
+    }
+
+    std::vector<bitset_lsh::match> const found = index.query(query, 3);
+
+    CHECK(!found.empty() and found.size() <= 3);
+    CHECK(found[0].id == i);
+
+    for (siz_t j = 0; j < found.size(); ++j) {
+      siz_t const exact = bitset::XOR_popcount(query, entries[found[j].id]);
+
+      CHECK(found[j].distance == static_cast<double>(exact));
+      CHECK(j == 0 or found[j - 1].distance <= found[j].distance);
+    }
+  }
+}
+
+// Unrelated bitsets share a key about as often as the similarity of their
+// hashes predicts, so keys do not collide for structural reasons
+TEST(lsh_key_spread) {
+  constexpr double density = 0.3;
+  constexpr siz_t queries = 50;
+
+  for (metric const mtr : { metric::hamming, metric::jaccard }) {
+    std::vector<bitset> entries;
+    bitset_lsh const index = make_index(mtr, 1024, 500, entries);
+    siz_t candidates = 0;
+
+    for (siz_t i = 0; i < queries; ++i) {
+      bitset const query = bitset::random(1024, density, 10000 + i);
+      candidates += index.query(query, index.count()).size();
+    }
+
+    // Chance of two independent bitsets agreeing on a hash
+    double const agree = (mtr == metric::hamming)
+      ? 1.0 - 2.0 * density * (1.0 - density)
+      : density * density / (2.0 * density - density * density);
+    double const expected = queries * index.tables() * index.count()
+      * std::pow(agree, static_cast<double>(index.hashes()));
+
+    CHECK(candidates < 2.0 * expected);
+    CHECK(candidates > expected / 4.0);
+  }
+}
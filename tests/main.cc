@@ -0,0 +1,33 @@
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include "test.hh"
+
+// Runs the registered cases whose name contains the first argument
+int main (int argc, char const* const* const argv) {
+  char const* const filter = (argc > 1) ? argv[1] : "";
+  std::size_t passed = 0, failed = 0;
+
+  for (tests::test_case const& tc : tests::registry()) {
+    if (std::strstr(tc.name, filter) == nullptr) {
+      continue;
+    }
+
+    try {
+      tc.run();
+      std::cout << "PASS " << tc.name << '\n';
+      ++passed;
+
+    } catch (tests::failure const& f) {
+      std::cout << "FAIL " << tc.name << ": " << f.what << '\n';
+      ++failed;
+
+    } catch (std::exception const& e) {
+      std::cout << "FAIL " << tc.name << ": exception " << e.what() << '\n';
+      ++failed;
+    }
+  }
+
+  std::cout << passed << " passed, " << failed << " failed\n";
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+// Checks the preconditions of the standard distributions
+#define _GLIBCXX_ASSERTIONS
+
+#include <random>
+#include <vector>
+#include "../evolution.hh"
+#include "test.hh"
+
+namespace evo = util::evolution;
+
+using genetic_t = evo::genetic<bitset, uintmax_t>;
+using gens = evo::bitset_generators<genetic_t::evo_t>;
+using siz_t = bitset::siz_t;
+
+// Positions where two bitsets differ
+static std::vector<siz_t> changed (bitset const& a, bitset const& b) {
+  std::vector<siz_t> pos;
+
+  for (siz_t i = 0; i < a.size(); ++i) {
+    if (a.get(i) != b.get(i)) {
+      pos.push_back(i);
+    }
+  }
+
+  return pos;
+}
+
+// Set bits, one at a time, to check the popcount kept by the flips
+static siz_t ones (bitset const& bs) {
+  siz_t count = 0;
+
+  for (siz_t i = 0; i < bs.size(); ++i) {
+    count += bs.get(i);
+  }
+
+  return count;
+}
+
+TEST(mutation_flip_uniform) {
+  std::mt19937_64 rnd{ 1 };
+
+  for (siz_t const size : { 1, 64, 1000, 100000 }) {
+    for (double const rate : { 0.0, 0.001, 0.1, 0.5, 0.999, 1.0, 3.0 }) {
+      bitset const original = bitset::random(size, 0.5, size);
+      bitset bs = original.copy();
+
+      siz_t const flips = gens::flip_uniform(bs, rate, rnd);
+
+      CHECK(changed(original, bs).size() == flips);
+      CHECK(bs.popcount() == ones(bs));
+
+      if (rate <= 0.0) {
+        CHECK(flips == 0);
+      } else if (rate >= 1.0) {
+        CHECK(flips == size);
+      } else if (size == 100000) {
+        double const expected = rate * size;
+        CHECK(std::abs(flips - expected) < 5 * std::sqrt(expected) + 1);
+      }
+    }
+  }
+}
+
+TEST(mutation_flip_exact) {
+  std::mt19937_64 rnd{ 2 };
+
+  for (siz_t const size : { 1, 10, 64, 1000 }) {
+    // Around the linear search threshold, and past the size
+    for (siz_t const count : { 0, 1, 5, 63, 64, 65, 200, 2000 }) {
+      for (int rep = 0; rep < 20; ++rep) {
+        bitset const original = bitset::random(size, 0.5, rep);
+        bitset bs = original.copy();
+
+        siz_t const flips = gens::flip_exact(bs, count, rnd);
+
+        CHECK(flips == std::min(count, size));
+        CHECK(changed(original, bs).size() == flips);
+        CHECK(bs.popcount() == ones(bs));
+      }
+    }
+  }
+
+  // Every position is chosen about as often
+  std::vector<siz_t> hits(50, 0);
+
+  for (int rep = 0; rep < 20000; ++rep) {
+    bitset bs{ 50 };
+    gens::flip_exact(bs, 3, rnd);
+
+    for (siz_t const pos : changed(bitset{ 50 }, bs)) {
+      hits[pos] += 1;
+    }
+  }
+
+  for (siz_t const h : hits) {
+    CHECK(h > 1000 and h < 1400);
+  }
+}
+
+TEST(mutation_flip_blocks) {
+  std::mt19937_64 rnd{ 3 };
+
+  for (siz_t const size : { 1, 7, 64, 1000 }) {
+    for (siz_t const length : { 1, 5, 64, 130, 5000 }) {
+      for (int rep = 0; rep < 20; ++rep) {
+        bitset const original = bitset::random(size, 0.5, rep);
+        bitset bs = original.copy();
+
+        // A single block is a run of contiguous flips
+        siz_t const flips = gens::flip_blocks(bs, 1, length, rnd);
+        std::vector<siz_t> const pos = changed(original, bs);
+
+        CHECK(flips == std::min(length, size));
+        CHECK(pos.size() == flips);
+        CHECK(pos.back() - pos.front() + 1 == flips);
+        CHECK(bs.popcount() == ones(bs));
+      }
+    }
+  }
+}
+
+TEST(mutation_mutators) {
+  genetic_t e{ 4, 5 };
+  bitset const one{ 1 };
+
+  // A rate of 1 / size is 1 on a single bit
+  CHECK(gens::uniform()(e, one).front().get(0));
+  CHECK(gens::uniform(1.0)(e, one).front().get(0));
+  CHECK(!one.get(0));
+
+  bitset const original = bitset::random(500, 0.5, 6);
+
+  CHECK(changed(original, gens::exact(7)(e, original).front()).size() == 7);
+  CHECK(changed(original, gens::blocks(1, 9)(e, original).front()).size() == 9);
+  CHECK(changed(original, gens::uniform(0.0)(e, original).front()).empty());
+}
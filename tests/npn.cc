@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+
+// Input i of a table is bit (n - 1 - i) of the position
+static bool input (siz_t pos, siz_t i, siz_t n) {
+  return (pos >> (n - 1 - i)) & 1;
+}
+
+// Applies a transform as described by bitset_npn::result
+static bitset apply (bitset const& f, bitset_npn::result const& res, siz_t n) {
+  bitset out{ f.size() };
+
+  for (siz_t x = 0; x < f.size(); ++x) {
+    siz_t y = 0;
+
+    for (siz_t i = 0; i < n; ++i) {
+      siz_t const to = res.perm[i];
+      bool const bit = input(x, i, n) ^ ((res.phase >> to) & 1);
+      y |= siz_t{ bit } << (n - 1 - to);
+    }
+
+    if (res.negated ^ f.get(y)) {
+      out.set(x);
+    }
+  }
+
+  return out;
+}
+
+TEST(npn_transform_reaches_canonical) {
+  bitset_npn npn;
+
+  for (siz_t n = 0; n <= 6; ++n) {
+    for (siz_t s = 0; s < 20; ++s) {
+      bitset const f = bitset::random(siz_t{ 1 } << n, 0.5, 100 * n + s);
+      bitset_npn::result const res = npn.canonical(f);
+
+      CHECK(res.table.size() == f.size());
+      CHECK(apply(f, res, n) == res.table);
+    }
+  }
+}
+
+// Every function of 3 and 4 inputs, which fall in 14 and 222 classes
+TEST(npn_class_counts) {
+  bitset_npn npn{ 0 };
+
+  for (auto const& [ n, classes ] : { std::pair<siz_t, siz_t>{ 3, 14 }, { 4, 222 } }) {
+    siz_t const size = siz_t{ 1 } << n;
+    std::set<std::string> found;
+
+    for (siz_t v = 0; v < (siz_t{ 1 } << size); ++v) {
+      bitset f{ size };
+
+      for (siz_t x = 0; x < size; ++x) {
+        if ((v >> x) & 1) {
+          f.set(x);
+        }
+      }
+
+      found.emplace(std::string{ npn.canonical(f).table });
+    }
+
+    CHECK(found.size() == classes);
+  }
+}
+
+// Equivalent tables of more inputs get the same form
+TEST(npn_invariance) {
+  bitset_npn npn{ 0 };
+  constexpr siz_t n = 6;
+
+  for (siz_t s = 0; s < 10; ++s) {
+    bitset const f = bitset::random(siz_t{ 1 } << n, 0.5, 500 + s);
+    bitset const canon = npn.canonical(f).table;
+
+    std::mt19937_64 rnd{ s };
+    bitset_npn::result res{ bitset{}, {}, 0, bool(rnd() & 1) };
+
+    std::iota(res.perm.begin(), res.perm.begin() + n, 0);
+    std::shuffle(res.perm.begin(), res.perm.begin() + n, rnd);
+    res.phase = rnd() & ((1u << n) - 1);
+
+    CHECK(npn.canonical(apply(f, res, n)).table == canon);
+  }
+}
+
+TEST(npn_cache) {
+  bitset_npn npn{ 2 };
+  bitset const a = bitset::random(32, 0.5, 1);
+  bitset const b = bitset::random(32, 0.5, 2);
+  bitset const c = bitset::random(32, 0.5, 3);
+
+  npn.canonical(a);
+  npn.canonical(b);
+  CHECK(npn.canonical(a).table == npn.canonical(a.copy()).table);
+  CHECK(npn.hits() == 2 and npn.misses() == 2);
+
+  npn.canonical(c);
+  CHECK(npn.size() == 2);
+
+  npn.canonical(b);
+  CHECK(npn.misses() == 4);
+}
+
+TEST(npn_reject_sizes) {
+  bitset_npn npn;
+
+  for (siz_t const size : { siz_t{ 0 }, siz_t{ 3 }, siz_t{ 96 }, siz_t{ 1 } << 17 }) {
+    CHECK_THROWS(npn.canonical(bitset{ size }), std::invalid_argument);
+  }
+}
@@ -0,0 +1,347 @@
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "../evolution.hh"
+#include "pareto.hh"
+#include "test.hh"
+
+using vec_chr = std::vector<int>;
+using vec_fit = std::vector<double>;
+using nsga_t = util::evolution::nsga<vec_chr, vec_fit>;
+using siz_t = nsga_t::siz_t;
+
+// Exposes the sorting steps of nsga on fitness arrays given by the test
+struct probe : nsga_t {
+  using nsga_t::nsga_t;
+  using nsga_t::load_columns;
+  using nsga_t::nd_sorting;
+  using nsga_t::nd_matrix;
+
+  using nsga_t::column;
+  using nsga_t::argsort;
+  using nsga_t::cd_fronts;
+
+  // Objectives compared through the comparators, or through the columns
+  probe& objectives (bool columns, bool maximize = false) {
+    for (siz_t d = 0; d < this->dimensions(); ++d) {
+      if (columns and maximize) {
+        this->set_maximize(d);
+      } else if (columns) {
+        this->set_minimize(d);
+      } else if (maximize) {
+        this->set_comparator([ d ] (vec_fit const& a, vec_fit const& b) { return a[d] > b[d]; }, d);
+        this->set_subtractor([ d ] (vec_fit const& a, vec_fit const& b) { return b[d] - a[d]; }, d);
+      } else {
+        this->set_comparator([ d ] (vec_fit const& a, vec_fit const& b) { return a[d] < b[d]; }, d);
+        this->set_subtractor([ d ] (vec_fit const& a, vec_fit const& b) { return a[d] - b[d]; }, d);
+      }
+    }
+
+    return *this;
+  }
+
+  dis_t const* distances (void) const { return this->dis_; }
+};
+
+// Fitness of <size> individuals, drawn from a grid of <grid> values so
+// that objectives tie
+static std::vector<vec_fit> make_fitness (siz_t size, siz_t dims, siz_t grid, uint64_t seed) {
+  std::mt19937_64 rnd{ seed };
+  std::vector<vec_fit> fit(size, vec_fit(dims));
+
+  for (vec_fit& f : fit) {
+    for (double& x : f) {
+      x = double(rnd() % grid);
+    }
+  }
+
+  return fit;
+}
+
+TEST(nsga_sorting_matches_brute_force) {
+  for (bool const columns : { false, true }) {
+    for (siz_t dims = 1; dims <= 5; ++dims) {
+      for (siz_t const size : { 1, 2, 7, 60, 300 }) {
+        for (siz_t const grid : { 3, 20, 1000000 }) {
+          siz_t const seed = size * dims + grid;
+          probe p{ size, dims, seed };
+          std::vector<vec_fit> const fit = make_fitness(size, dims, grid, seed);
+          std::vector<siz_t> const expected = tests::peel_ranks(fit);
+          std::vector<siz_t> ranks(size), ranked(size), ends(size);
+
+          p.objectives(columns);
+          CHECK(p.load_columns(fit.data(), size) == columns);
+
+          siz_t const total = *std::max_element(expected.begin(), expected.end()) + 1;
+          siz_t const fronts = p.nd_sorting(fit.data(), ranks.data(), ranked.data(), ends.data(), size, size);
+
+          CHECK(ranks == expected);
+          CHECK(fronts == total);
+
+          // Members grouped by front, each in increasing index order
+          for (siz_t f = 0, start = 0; f < fronts; start = ends[f++]) {
+            for (siz_t i = start; i < ends[f]; ++i) {
+              CHECK(ranks[ranked[i]] == f);
+              CHECK(i == start or ranked[i - 1] < ranked[i]);
+            }
+          }
+
+          CHECK(ends[fronts - 1] == size);
+
+          // Fronts needed to reach half of the population
+          siz_t const half = (size + 1) / 2;
+          siz_t const needed = p.nd_sorting(fit.data(), ranks.data(), ranked.data(), ends.data(), size, half);
+
+          CHECK(ends[needed - 1] >= half);
+          CHECK(needed == 1 or ends[needed - 2] < half);
+        }
+      }
+    }
+  }
+}
+
+TEST(nsga_matrix_matches_brute_force) {
+  for (siz_t dims = 3; dims <= 6; ++dims) {
+    for (siz_t const size : { 1, 255, 256, 257, 1100 }) {
+      probe p{ size, dims, size + dims };
+      std::vector<vec_fit> const fit = make_fitness(size, dims, dims == 3 ? 8 : 1000, size + dims);
+      std::vector<siz_t> ranks(size);
+
+      p.objectives(true).load_columns(fit.data(), size);
+      p.set_parallel(true);
+
+      CHECK(p.nd_matrix(ranks.data(), size) == *std::max_element(ranks.begin(), ranks.end()) + 1);
+      CHECK(ranks == tests::peel_ranks(fit));
+    }
+  }
+}
+
+// Equal distances up to rounding (the paths may contract the sums into
+// fused multiply-adds differently), where undefined ones (a front with a
+// single value of an objective) must be undefined in both
+static bool same_distance (double a, double b) {
+  return a == b or std::abs(a - b) <= 1e-12 * std::abs(a)
+    or (std::isnan(a) and std::isnan(b));
+}
+
+TEST(nsga_argsort_matches_stable_sort) {
+  double const inf = std::numeric_limits<double>::infinity();
+  double const special[] = { 0.0, -0.0, inf, -inf, -1.5, 1e-310, -1e-310, 1e300 };
+
+  for (siz_t const size : { 2, 255, 256, 257, 3000 }) {
+    siz_t const total = size + size / 4;
+    probe p{ total, 1, size };
+    std::mt19937_64 rnd{ size };
+    std::vector<vec_fit> fit(total, vec_fit(1));
+
+    for (vec_fit& f : fit) {
+      f[0] = (rnd() % 4 == 0) ? special[rnd() % 8] : double(rnd() % 200) - 100.0;
+    }
+
+    p.objectives(true).load_columns(fit.data(), total);
+
+    // <size> of the positions, in any order
+    std::vector<siz_t> idx(total);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::shuffle(idx.begin(), idx.end(), rnd);
+    idx.resize(size);
+
+    std::vector<siz_t> expected = idx;
+    std::stable_sort(expected.begin(), expected.end(), [ &fit ] (siz_t a, siz_t b) {
+      return fit[a][0] < fit[b][0];
+    });
+
+    p.argsort(p.column(0), idx.data(), idx.size(), 0);
+    CHECK(idx == expected);
+  }
+}
+
+TEST(nsga_crowding_columns_match_comparators) {
+  for (bool const maximize : { false, true }) {
+    for (siz_t dims = 1; dims <= 4; ++dims) {
+      for (siz_t const size : { 1, 2, 3, 50, 600 }) {
+        for (siz_t const grid : { 4, 1000 }) {
+          std::vector<vec_fit> const fit = make_fitness(size, dims, grid, size + grid);
+          std::vector<std::vector<double>> distances;
+          std::vector<std::vector<siz_t>> ranks;
+
+          for (bool const columns : { false, true }) {
+            probe p{ size, dims, 1 };
+            std::vector<siz_t> rank(size), ranked(size), ends(size);
+
+            p.objectives(columns, maximize).load_columns(fit.data(), size);
+
+            siz_t const fronts = p.nd_sorting(fit.data(), rank.data(), ranked.data(), ends.data(), size, size);
+
+            p.cd_fronts(fit.data(), ranked.data(), ends.data(), fronts);
+            distances.emplace_back(p.distances(), p.distances() + size);
+            ranks.push_back(rank);
+          }
+
+          CHECK(ranks[0] == ranks[1]);
+
+          for (siz_t i = 0; i < size; ++i) {
+            CHECK(same_distance(distances[0][i], distances[1][i]));
+          }
+        }
+      }
+    }
+  }
+}
+
+// Whole runs with and without columns take the same steps
+TEST(nsga_columns_match_comparators) {
+  for (bool const maximize : { false, true }) {
+    std::vector<probe> runs;
+    runs.reserve(2);
+
+    for (bool const columns : { false, true }) {
+      probe& p = runs.emplace_back(300, 3, 7);
+
+      p.objectives(columns, maximize);
+      p.set_creator([] (nsga_t::evo_t& ev) {
+        vec_chr c(3);
+
+        for (int& x : c) {
+          x = ev.random()() % 50;
+        }
+
+        return c;
+      });
+      p.set_evaluator([] (vec_chr& c) {
+        return vec_fit{ double(c[0] + c[1]), double(c[1] - c[2]), double(c[2] % 7) - c[0] };
+      });
+      p.set_generator([] (nsga_t::evo_t& ev) {
+        vec_chr c = ev.chr_at(ev.random()() % ev.size());
+        c[ev.random()() % c.size()] = ev.random()() % 50;
+        return std::vector<vec_chr>{ c };
+      });
+      p.populate(300);
+    }
+
+    for (siz_t s = 0; s < 30; ++s) {
+      runs[0].step();
+      runs[1].step();
+
+      for (siz_t i = 0; i < runs[0].size(); ++i) {
+        CHECK(runs[0].fit_at(i) == runs[1].fit_at(i));
+        CHECK(runs[0].front_at(i) == runs[1].front_at(i));
+        CHECK(same_distance(runs[0].distance_at(i), runs[1].distance_at(i)));
+      }
+    }
+  }
+}
+
+using steady_t = util::evolution::nsga_steady<vec_chr, vec_fit>;
+
+// Objectives of <dims> genes, folded on a grid of <grid> values
+static void setup_steady (steady_t& e, siz_t dims, int grid, bool columns) {
+  for (siz_t d = 0; d < dims; ++d) {
+    if (columns) {
+      e.set_minimize(d);
+    } else {
+      e.set_comparator([ d ] (vec_fit const& a, vec_fit const& b) { return a[d] < b[d]; }, d);
+      e.set_subtractor([ d ] (vec_fit const& a, vec_fit const& b) { return a[d] - b[d]; }, d);
+    }
+  }
+
+  e.set_creator([ dims ] (steady_t::evo_t& ev) {
+    vec_chr c(dims);
+
+    for (int& x : c) {
+      x = ev.random()() % 1000;
+    }
+
+    return c;
+  });
+  e.set_evaluator([ dims, grid ] (vec_chr& c) {
+    vec_fit f(dims);
+
+    for (siz_t d = 0; d < dims; ++d) {
+      f[d] = (c[d] * (d + 3) + c[(d + 1) % dims] * 7) % grid;
+    }
+
+    return f;
+  });
+  e.set_generator([] (steady_t::evo_t& ev) {
+    vec_chr c = ev.chr_at(ev.random()() % ev.size());
+    c[ev.random()() % c.size()] = ev.random()() % 1000;
+    return std::vector<vec_chr>{ c };
+  });
+}
+
+// Ranks and crowding distances of the population are those of a full sort
+static void check_steady (steady_t const& e, bool columns) {
+  siz_t const size = e.size();
+  std::vector<vec_fit> const fit(e.fitbegin(), e.fitend());
+  std::vector<siz_t> const expected = tests::peel_ranks(fit);
+
+  probe p{ size, e.dimensions(), 1 };
+  std::vector<siz_t> ranks(size), ranked(size), ends(size);
+
+  p.objectives(columns).load_columns(fit.data(), size);
+
+  siz_t const fronts = p.nd_sorting(fit.data(), ranks.data(), ranked.data(), ends.data(), size, size);
+
+  p.cd_fronts(fit.data(), ranked.data(), ends.data(), fronts);
+  CHECK(e.fronts() == fronts);
+
+  for (siz_t i = 0; i < size; ++i) {
+    CHECK(e.front_at(i) == expected[i]);
+    CHECK(same_distance(e.distance_at(i), p.distances()[i]));
+  }
+}
+
+TEST(nsga_steady_matches_full_sort) {
+  for (bool const columns : { false, true }) {
+    for (siz_t const dims : { 2, 3 }) {
+      for (int const grid : { 7, 1000003 }) {
+        steady_t e{ 60, dims, dims + grid };
+
+        setup_steady(e, dims, grid, columns);
+        e.populate(60);
+        check_steady(e, columns);
+
+        for (siz_t s = 0; s < 2000; ++s) {
+          e.step();
+          check_steady(e, columns);
+        }
+
+        CHECK(e.evaluations() == 2000);
+      }
+    }
+  }
+}
+
+// Mean of the objectives over the population
+static double mean_fitness (steady_t const& e) {
+  double sum = 0.0;
+
+  for (siz_t i = 0; i < e.size(); ++i) {
+    sum += std::accumulate(e.fit_at(i).begin(), e.fit_at(i).end(), 0.0);
+  }
+
+  return sum / e.size();
+}
+
+// Asynchronous runs converge, and keep ranks and crowding distances
+// consistent with a full sort
+TEST(nsga_steady_run) {
+  for (siz_t const threads : { 1, 4 }) {
+    steady_t e{ 200, 3, 2 };
+
+    setup_steady(e, 3, 1000003, true);
+    e.populate(200);
+
+    double const start = mean_fitness(e);
+    e.run(3000, threads);
+
+    CHECK(e.evaluations() == 3000);
+    CHECK(e.accepted() > 0 and e.accepted() <= e.evaluations());
+    CHECK(e.size() == 200);
+    CHECK(mean_fitness(e) < start / 2);
+    check_steady(e, true);
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Brute-force Pareto ranking, the reference of the sorting tests
+namespace tests {
+
+  // Tests if <a> dominates <b>, minimizing every objective
+  template <typename V>
+  bool dominates (V const& a, V const& b) {
+    bool better = false;
+
+    for (std::size_t d = 0; d < a.size(); ++d) {
+      if (a[d] > b[d]) {
+        return false;
+      }
+
+      better |= a[d] < b[d];
+    }
+
+    return better;
+  }
+
+  // Ranks of the <members> among <positions> by peeling the non-dominated
+  // ones, front by front, where dom(a, b) tests if a dominates b
+  // Positions that are not members are ranked -1
+  template <typename DOM>
+  std::vector<uintmax_t> peel_ranks (
+    std::vector<uintmax_t> const& members, uintmax_t positions, DOM const& dom
+  ) {
+    uintmax_t const none = uintmax_t(-1);
+    std::vector<uintmax_t> ranks(positions, none);
+
+    for (uintmax_t k = 0, left = members.size(); left > 0; ++k) {
+      std::vector<uintmax_t> front;
+
+      for (uintmax_t const i : members) {
+        bool const free = ranks[i] == none and std::none_of(members.begin(), members.end(),
+          [ & ] (uintmax_t j) { return ranks[j] == none and dom(j, i); }
+        );
+
+        if (free) {
+          front.push_back(i);
+        }
+      }
+
+      for (uintmax_t const i : front) {
+        ranks[i] = k;
+      }
+
+      left -= front.size();
+    }
+
+    return ranks;
+  }
+
+  // Ranks of a set of objective vectors
+  template <typename V>
+  std::vector<uintmax_t> peel_ranks (std::vector<V> const& values) {
+    std::vector<uintmax_t> members(values.size());
+    std::iota(members.begin(), members.end(), 0);
+
+    return peel_ranks(members, values.size(), [ &values ] (uintmax_t a, uintmax_t b) {
+      return dominates(values[a], values[b]);
+    });
+  }
+
+};
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "../evolution.hh"
+#include "test.hh"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace evo = util::evolution;
+
+using genetic_t = evo::genetic<bitset, uintmax_t>;
+using steady_t = evo::steady_state<bitset, uintmax_t>;
+using base_t = genetic_t::evo_t;
+using gens = evo::bitset_generators<base_t>;
+using base_gens = evo::base_generators<base_t>;
+
+// Runs <body> with the given number of OpenMP threads
+static void with_threads (int threads, std::function<void()> const& body) {
+#ifdef _OPENMP
+  int const old = omp_get_max_threads();
+  omp_set_num_threads(threads);
+  body();
+  omp_set_num_threads(old);
+#else
+  (void) threads;
+  body();
+#endif
+}
+
+// Onemax on <bits> bits, as the number of zeros to be minimized
+// Generator calls are delayed by up to 100us, so that they interleave
+static void setup (base_t& e, base_t::generator const& gen, bitset::siz_t bits) {
+  e.set_creator([ bits ] (base_t& ev) { return bitset::random(bits, ev.random()); });
+  e.set_evaluator([] (bitset& c) { return uintmax_t(c.size() - c.popcount()); });
+  e.set_comparator([] (uintmax_t a, uintmax_t b) { return a < b; });
+  e.set_generator([ gen ] (base_t& ev) {
+    std::this_thread::sleep_for(std::chrono::microseconds(ev.stream()() % 100));
+    return gen(ev);
+  });
+}
+
+static std::vector<bitset> population (base_t const& e) {
+  std::vector<bitset> chrs;
+
+  for (base_t::siz_t i = 0; i < e.size(); ++i) {
+    chrs.emplace_back(e.chr_at(i).copy());
+  }
+
+  return chrs;
+}
+
+// Generation, mutation and selection give the same populations in serial
+// mode and with any number of threads
+TEST(evolution_same_on_any_thread) {
+  std::vector<base_t::generator> const generators{
+    base_gens::always_cross(gens::uniform_cross(gens::tournament(2)), gens::uniform(), 0.5),
+    base_gens::always_cross(gens::points_cross(3, gens::tournament(3)), gens::exact(2), 0.3),
+    base_gens::cross_or_mutate(
+      gens::half_uniform_cross(gens::tournament(2)),
+      [] (base_t& ev) { return gens::blocks(2, 5)(ev, ev.chr_at(0)); }, 0.2
+    )
+  };
+
+  for (base_t::generator const& gen : generators) {
+    std::vector<std::vector<bitset>> results;
+
+    for (int const threads : { 0, 1, 4 }) {
+      genetic_t e{ 41, 9 };
+
+      setup(e, gen, 300);
+      e.set_parallel(threads > 0);
+      e.populate(41);
+
+      with_threads(std::max(threads, 1), [ &e ] {
+        for (int s = 0; s < 20; ++s) {
+          e.step();
+        }
+      });
+
+      results.push_back(population(e));
+    }
+
+    CHECK(results[0] == results[1]);
+    CHECK(results[0] == results[2]);
+  }
+}
+
+// Each batch of an asynchronous run is a generation of its own, so a run
+// on a single worker is reproducible and does not repeat its draws
+TEST(evolution_run_advances_streams) {
+  steady_t e{ 16, 3 };
+
+  setup(e, base_gens::always_cross(gens::uniform_cross(gens::tournament(2)), gens::uniform(), 0.5), 128);
+  e.populate(16);
+
+  steady_t copy{ e };
+  steady_t::siz_t const start = e.generation();
+
+  e.run(400, 1);
+  copy.run(400, 1);
+
+  CHECK(e.generation() == start + 200);
+  CHECK(population(e) == population(copy));
+  CHECK(e.best_fit() < 40);
+}
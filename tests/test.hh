@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Minimal test harness: TEST registers a case, which fails on the first
+// CHECK that does not hold
+namespace tests {
+
+  // Failed check, with its location and expression
+  struct failure {
+    std::string what;
+  };
+
+  struct test_case {
+    char const* name;
+    void (*run) (void);
+  };
+
+  // Every registered case, in registration order
+  inline std::vector<test_case>& registry (void) {
+    static std::vector<test_case> cases;
+    return cases;
+  }
+
+  struct registrar {
+    registrar (char const* name, void (*run) (void)) {
+      registry().push_back({ name, run });
+    }
+  };
+
+};
+
+#define TEST(name) \
+  static void test_##name (void); \
+  static tests::registrar const test_registrar_##name{ #name, test_##name }; \
+  static void test_##name (void)
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      throw tests::failure{ \
+        std::string{ __FILE__ } + ":" + std::to_string(__LINE__) + ": " + #cond \
+      }; \
+    } \
+  } while (0)
+
+// Checks that an expression throws an exception of the given type
+#define CHECK_THROWS(expr, type) \
+  do { \
+    bool thrown = false; \
+    try { (void) (expr); } catch (type const&) { thrown = true; } \
+    CHECK(thrown && #expr " throws " #type); \
+  } while (0)
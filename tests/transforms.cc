@@ -0,0 +1,65 @@
+#include <stdexcept>
+#include "../bitset.hh"
+#include "test.hh"
+
+using siz_t = bitset::siz_t;
+
+TEST(moebius_matches_naive) {
+  for (siz_t n = 0; n <= 10; ++n) {
+    siz_t const size = siz_t{ 1 } << n;
+    bitset const f = bitset::random(size, 0.5, 10 + n);
+    bitset anf = f.copy();
+
+    anf.moebius();
+
+    siz_t ones = 0;
+
+    // Coefficient of a monomial: XOR of f over the subsets of its inputs
+    for (siz_t u = 0; u < size; ++u) {
+      bool coef = false;
+
+      for (siz_t x = 0; x < size; ++x) {
+        coef ^= ((x & u) == x) and f.get(x);
+      }
+
+      CHECK(anf.get(u) == coef);
+      ones += coef;
+    }
+
+    CHECK(anf.popcount() == ones);
+    CHECK(anf.moebius() == f);
+  }
+}
+
+TEST(walsh_matches_naive) {
+  for (siz_t n = 0; n <= 13; ++n) {
+    siz_t const size = siz_t{ 1 } << n;
+    bitset const f = bitset::random(size, 0.4, 20 + n);
+    std::vector<int32_t> narrow(size);
+    std::vector<int64_t> wide(size);
+
+    f.walsh(narrow.data());
+    f.walsh(wide.data());
+
+    for (siz_t u = 0; u < size; u += (n > 10) ? 97 : 1) {
+      int64_t sum = 0;
+
+      for (siz_t x = 0; x < size; ++x) {
+        sum += ((f.get(x) ^ util::popcount(u & x)) & 1) ? -1 : 1;
+      }
+
+      CHECK(narrow[u] == sum);
+      CHECK(wide[u] == sum);
+    }
+  }
+}
+
+TEST(transforms_reject_sizes) {
+  for (siz_t const size : { siz_t{ 0 }, siz_t{ 3 }, siz_t{ 96 }, siz_t{ 1000 } }) {
+    bitset bs{ size };
+    std::vector<int64_t> out(size + 1);
+
+    CHECK_THROWS(bs.moebius(), std::invalid_argument);
+    CHECK_THROWS(bs.walsh(out.data()), std::invalid_argument);
+  }
+}
@@ -19,6 +19,7 @@
 #include "allocator.hh"
 #include "container.hh"
 #include "interrupt.hh"
+#include "random.hh"
 
 #include "bitset.hh"
 #include "iterator.hh"
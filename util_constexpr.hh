@@ -321,6 +321,24 @@ namespace util {
     }
   }
 
+  // Counts the number of trailing zeros on <value> (undefined for zero)
+  template <
+    typename T,
+    typename = typename std::enable_if_t<std::is_integral_v<T>>
+  >
+  constexpr uintmax_t ctz (T value) {
+    return __builtin_ctzll(value);
+  }
+
+  // Whether <value> is a power of two (zero is not)
+  template <
+    typename T,
+    typename = typename std::enable_if_t<std::is_integral_v<T>>
+  >
+  constexpr bool is_pow2 (T value) {
+    return value != 0 and (value & (value - 1)) == 0;
+  }
+
   // Compile time power of <value>
   template <intmax_t EXP, typename T>
   constexpr T pow (T const& value) {